@@ -24,29 +24,174 @@
 #define PrimeFactorizer_h
 #pragma once
 
+#ifdef USING_GMP
+#include <gmpxx.h>
+#endif
+
 #include <stdint.h>
+#include <algorithm>
 #include <vector>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
+#include <chrono>
+
+
+template <typename uintT>
+//-----------------------------------------------------------------------------
+struct FactorMethods {
+//  what trial division can use besides dividing, per integer type.
+//  IsPrime() is false when it is not known, then trial division has to
+//  tell; Split() finds a proper divisor of a composite, false when it
+//  cannot (or the deadline passed). Only with canSplit is trial
+//  division stopped early, at trialLimit, and the rest split.
+//-----------------------------------------------------------------------------
+    typedef std::chrono::steady_clock::time_point time_point;
+    enum { canSplit = 0 };
+    static unsigned long trialLimit(void) { return 0; }
+    static bool IsPrime(const uintT&) { return false; }
+    static bool Split(const uintT&, uintT&, const time_point*) { return false; }
+};
+
+template <>
+//-----------------------------------------------------------------------------
+struct FactorMethods<uintmax_t> {
+//  trial division to 2**32 is quick, so there is no Split()
+//-----------------------------------------------------------------------------
+    typedef std::chrono::steady_clock::time_point time_point;
+    enum { canSplit = 0 };
+    static unsigned long trialLimit(void) { return 0; }
+    static bool Split(const uintmax_t&, uintmax_t&, const time_point*) { return false; }
+
+    static bool IsPrime(const uintmax_t& v)
+    //  Miller-Rabin with the first 12 primes as bases, which is exact
+    //  below 3.3e24, so for all 64 bit values
+    {
+#if defined(__SIZEOF_INT128__) && UINTMAX_MAX == UINT64_MAX
+        typedef unsigned __int128 wide_t;
+        static const unsigned bases[12] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37 };
+        if (v < 2)
+            return false;
+        for (unsigned i=0; i<12; i++) {
+            if (v % bases[i] == 0)
+                return v == bases[i];
+        }
+        uintmax_t d = v-1;
+        unsigned s = 0;
+        for (; !(d & 1); s++)
+            d >>= 1;
+        for (unsigned i=0; i<12; i++) {
+            uintmax_t x = 1, b = bases[i];
+            for (uintmax_t e=d; e; e>>=1) {
+                if (e & 1)
+                    x = uintmax_t(wide_t(x) * b % v);
+                b = uintmax_t(wide_t(b) * b % v);
+            }
+            if (x == 1 || x == v-1)
+                continue;
+            unsigned r = 1;
+            for (; r<s; r++) {
+                x = uintmax_t(wide_t(x) * x % v);
+                if (x == v-1)
+                    break;
+            }
+            if (r == s)
+                return false;
+        }
+        return true;
+#else
+        (void)v;
+        return false;
+#endif
+    }
+};
+
+#ifdef USING_GMP
+template <>
+//-----------------------------------------------------------------------------
+struct FactorMethods<mpz_class> {
+//  Baillie-PSW plus Miller-Rabin rounds (no composite is known to pass
+//  them), and Brent's variant of Pollard's rho after trial division to
+//  2**24, which finds a prime p in about sqrt(p) steps
+//-----------------------------------------------------------------------------
+    typedef std::chrono::steady_clock::time_point time_point;
+    enum { canSplit = 1 };
+    static unsigned long trialLimit(void) { return 1ul << 24; }
+
+    static bool IsPrime(const mpz_class& v)
+    {
+        return mpz_probab_prime_p(v.get_mpz_t(), 25) > 0;
+    }
+
+    static bool Split(const mpz_class& n, mpz_class& d, const time_point* deadline)
+    //  y = y*y+c mod n, with the differences to the saved x multiplied
+    //  up 128 at a time before a gcd; if that overshoots, step back
+    {
+        const unsigned long batch = 128;
+        for (unsigned long c=1; ; c++) {
+            mpz_class x, y = 2, ys, q = 1, g = 1, diff;
+            for (unsigned long r=1; g==1; r*=2) {
+                x = y;
+                for (unsigned long i=0; i<r; i++)
+                    y = (y*y + c) % n;
+                for (unsigned long k=0; k<r && g==1; k+=batch) {
+                    ys = y;
+                    for (unsigned long i=0; i<batch && i<r-k; i++) {
+                        y = (y*y + c) % n;
+                        diff = x - y;
+                        q = (q * abs(diff)) % n;
+                    }
+                    g = gcd(q, n);
+                    if (deadline && std::chrono::steady_clock::now() > *deadline)
+                        return false;
+                }
+            }
+            if (g == n) {
+                do {
+                    ys = (ys*ys + c) % n;
+                    diff = x - ys;
+                    g = gcd(abs(diff), n);
+                } while (g == 1);
+            }
+            if (g != n) {
+                d = g;
+                return true;
+            }
+        }
+    }
+};
+#endif
 
 
 template <typename uintT=uintmax_t, typename fltT=long double>
 //-----------------------------------------------------------------------------
 class PrimeFactorizer {
-//  integer type is uintT, fltT is needed for std::sqrt()
+//  integer type is uintT; fltT only remains for the existing users.
+//  Square roots are exact integer ones, mpz_sqrt() for mpz_class.
+//  With a time limit (in seconds, 0 for none), factoring stops when it
+//  is exceeded. Then the factors found so far are kept, and the rest of
+//  the number, not known to be prime, is the Cofactor().
+//  Given a modulus, all prime factors above 7 must be 1 mod modulus,
+//  and only those are tried. For 2**n-1 they are 1 mod 2n if n is an
+//  odd prime, or in general once the primes of 2**d-1 for all divisors
+//  d of n are divided out (1 mod n, and odd). Trial division ends when
+//  what is left is a (probable) prime, see FactorMethods.
 //-----------------------------------------------------------------------------
   public:
-    PrimeFactorizer(uintT num);
+    PrimeFactorizer(uintT num, double maxSeconds=0, unsigned long modulus=2);
 
     const std::vector<uintT>& Primes(void) const { return primes; }
     const std::vector<uintT>& Orders(void) const { return orders; }
 
+    bool Complete(void) const { return cofactor==uintT(1); }
+    const uintT& Cofactor(void) const { return cofactor; } // 1 if complete
+
     void print(std::ostream& os) const;
 
   private:
     std::vector<uintT> primes;
     std::vector<uintT> orders;
+    uintT cofactor;
     
     void AddPrimeFactor(const uintT& v);
     static uintT SquareRoot(const uintT& v);
@@ -68,47 +213,100 @@ std::ostream& operator<< (std::ostream& os, PrimeFactorizer<uintT,fltT> pf)
 
 template <typename uintT, typename fltT>
 //-----------------------------------------------------------------------------
-PrimeFactorizer<uintT,fltT>::PrimeFactorizer(uintT num)
+PrimeFactorizer<uintT,fltT>::PrimeFactorizer(uintT num, double maxSeconds, unsigned long modulus)
+//  after 2, 3, 5 and 7, the candidates are 1+k*modulus, except multiples
+//  of 3, 5 and 7, which a table over k mod 105 leaves out. For modulus
+//  2 this is the wheel of 210 (48 of every 210 numbers are tried). The
+//  clock is looked at every 4096 candidates. The rest is tested for
+//  primality at the start and after each factor found, and where the
+//  type can, split into factors once the candidates pass trialLimit.
 //-----------------------------------------------------------------------------
+:   cofactor(1)
 {
+    typedef std::chrono::steady_clock clock_type;
+    typedef FactorMethods<uintT> methods;
+    const clock_type::time_point start = clock_type::now();
+    const clock_type::time_point deadline = start +
+        std::chrono::duration_cast<clock_type::duration>(std::chrono::duration<double>(maxSeconds));
+    unsigned untilCheck = 4096;
+
     if (num==0) return;
     if (num==1) {
         AddPrimeFactor(1);
         return;
     }
 
-    // elimimate all factors of 2
-    while ((num & uintT(1))==0) {
-        AddPrimeFactor(2);
-        num >>= 1;
-        if (num==1) return;
+    static const unsigned smallPrimes[4] = { 2, 3, 5, 7 };
+    for (unsigned i=0; i<4; i++) {
+        while (num % smallPrimes[i] == 0) {
+            AddPrimeFactor(smallPrimes[i]);
+            num /= smallPrimes[i];
+            if (num==1) return;
+        }
     }
-    
-    uintT lastPrime = SquareRoot(num);
-    uintT primeCandidate = 3;
-    bool doubleSkip = 0; // to remove 3*n from the candidates
+
+    // the candidates are odd
+    if (!modulus) modulus = 2;
+    if (modulus & 1) modulus *= 2;
+    bool skip[105];
+    for (unsigned k=0; k<105; k++) {
+        const unsigned long cand = 1 + k*(modulus % 105);
+        skip[k] = !(cand%3) || !(cand%5) || !(cand%7);
+    }
+
+    bool prime = methods::IsPrime(num);
+    uintT lastPrime = prime ? uintT(0) : SquareRoot(num);
+    if (methods::canSplit && lastPrime > uintT(methods::trialLimit()))
+        lastPrime = methods::trialLimit();
+    uintT primeCandidate = uintT(1) + uintT(modulus);
+    unsigned k = 1;
     while (primeCandidate<=lastPrime) {
-        if ( (num % primeCandidate)==0 ) {
-            //std::cout << "# " << num << " = ";
+        if (!skip[k] && (num % primeCandidate)==0) {
             num /= primeCandidate;
-            lastPrime = SquareRoot(num);
-            //std::cout << primeCandidate << " * " << num << std::endl;
             AddPrimeFactor(primeCandidate);
-        } else {
-            // not a multiple, move on
-            primeCandidate += 2;
-            // this could be smarter (prime wheel) to be faster
-#if 1
-            // currently skips multipes of 2 and 3
-            if (primeCandidate<=7)
-                doubleSkip = 0;
-            if (doubleSkip)
-                primeCandidate += 2;
-            doubleSkip = !doubleSkip;
-#endif
+            prime = num % primeCandidate != 0 && methods::IsPrime(num);
+            if (prime)
+                break;
+            const uintT root = SquareRoot(num);
+            if (root < lastPrime)
+                lastPrime = root;
+            continue;
+        }
+        // not a multiple, move on
+        if (maxSeconds>0 && !--untilCheck) {
+            untilCheck = 4096;
+            if (clock_type::now() > deadline) {
+                cofactor = num;
+                return;
+            }
         }
+        primeCandidate += modulus;
+        if (++k == 105)
+            k = 0;
     }
-    AddPrimeFactor(num);
+    if (prime || !methods::canSplit || num < primeCandidate*primeCandidate) {
+        AddPrimeFactor(num);
+        return;
+    }
+
+    // split what is left, the pieces that are not split in time
+    // make up the cofactor
+    std::vector<uintT> found, work(1, num);
+    while (!work.empty()) {
+        const uintT part = work.back();
+        work.pop_back();
+        uintT d;
+        if (methods::IsPrime(part))
+            found.push_back(part);
+        else if (methods::Split(part, d, maxSeconds>0 ? &deadline : 0)) {
+            work.push_back(d);
+            work.push_back(part / d);
+        } else
+            cofactor *= part;
+    }
+    std::sort(found.begin(), found.end());
+    for (unsigned i=0; i<found.size(); i++)
+        AddPrimeFactor(found[i]);
 }
 
 template <typename uintT, typename fltT>
@@ -116,7 +314,7 @@ template <typename uintT, typename fltT>
 void PrimeFactorizer<uintT,fltT>::print(std::ostream& os) const
 //-----------------------------------------------------------------------------
 {
-    if (!primes.size()) {
+    if (!primes.size() && Complete()) {
         os << "0";
     }
     for (unsigned pidx=0; pidx<primes.size(); pidx++) {
@@ -128,6 +326,8 @@ void PrimeFactorizer<uintT,fltT>::print(std::ostream& os) const
             os << primes[pidx] << "**" << orders[pidx];
         }
     }
+    if (!Complete())
+        os << (primes.size() ? " * " : "") << cofactor << " (not factored)";
 }
 
 template <typename uintT, typename fltT>
@@ -149,16 +349,36 @@ void PrimeFactorizer<uintT,fltT>::AddPrimeFactor(const uintT& v)
     }
 }
 
-#include <cmath>
-
 template <typename uintT, typename fltT>
 //-----------------------------------------------------------------------------
 uintT PrimeFactorizer<uintT,fltT>::SquareRoot(const uintT& v)
+//  the largest r with r*r <= v, by Newton's method from above
+//-----------------------------------------------------------------------------
+{
+    if (v < uintT(2))
+        return v;
+    unsigned bits = 0;
+    for (uintT t = v; t != uintT(0); t >>= 1)
+        bits++;
+    uintT r = uintT(1) << ((bits+1)/2);
+    while (true) {
+        uintT next = (r + v/r) >> 1;
+        if (!(next < r))
+            return r;
+        r = next;
+    }
+}
+
+#ifdef USING_GMP
+template <>
+//-----------------------------------------------------------------------------
+inline mpz_class PrimeFactorizer<mpz_class,mpf_class>::SquareRoot(const mpz_class& v)
 //-----------------------------------------------------------------------------
 {
-    fltT vv = v;
-    vv = std::sqrt(vv);
-    return uintT(vv);
+    mpz_class r;
+    mpz_sqrt(r.get_mpz_t(), v.get_mpz_t());
+    return r;
 }
+#endif
 
 #endif
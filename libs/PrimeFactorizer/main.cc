@@ -31,38 +31,85 @@
 #endif
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <iostream>
+#include <fstream>
+#include <limits>
+#include <atomic>
+#include <thread>
 
 //-----------------------------------------------------------------------------
 void usage(const char* argv0)
 //-----------------------------------------------------------------------------
 {
     printf("usage: %s [-b][-?] [num] [num] [...]\n", argv0);
+    printf("       %s [-b] -s|-f file [-j threads] [-t seconds]\n", argv0);
     printf(" computes and prints prime factors (with orders) for a provided integer\n");
 #ifdef USING_GMP
     printf("   -b  use bignum library (GMP)\n");
 #endif
+    printf("   -s  stream mode: factor the numbers on stdin, one per line\n");
+    printf("   -f  stream mode, reading the numbers from file\n");
+    printf("   -j  threads for stream mode, default: one per hardware thread\n");
+    printf("   -t  give up on a number after this many seconds, default: 0, never\n");
     printf("   -?  this help\n");
     printf(" if no numbers are provided on the command line, program is interactive\n");
+    printf(" numbers may also be given as 2^n-1 or 2**n-1\n");
+    printf(" stream mode writes one line per number, in input order:\n");
+    printf("   N ok P[^E] ...           the prime factors P, with E if above 1\n");
+    printf("   N timeout P[^E] ... ?C   stopped, C is the part not factored\n");
+    printf("   LINE error               not a number\n");
+    printf(" mlpolygen --factor-cache loads these for the numbers 2**n-1\n");
 }
 
-
-template <typename uintT, typename fltT>
+template <typename uintT>
 //-----------------------------------------------------------------------------
-int PrintFactorsOf(const std::string& str)
+bool ParseNumber(const std::string& str, uintT& val, unsigned long* modulus=0)
+//  a number, or 2^n-1 or 2**n-1 (without overflow). For an odd prime n,
+//  its prime factors are 1 mod 2n, the modulus for the PrimeFactorizer.
 //-----------------------------------------------------------------------------
 {
+    if (modulus)
+        *modulus = 2;
     std::stringstream ss(str);
-    uintT val = 0;
-    bool extracted = !!(ss >> val);
-    if (!extracted)
-        return -1;
+    ss >> std::ws;
+    const std::string::size_type pos = size_t(ss.tellg());
+    unsigned n = 0;
+    char minus = 0, one = 0;
+    if (!str.compare(pos, 2, "2^") || !str.compare(pos, 3, "2**")) {
+        ss.seekg(pos + (str[pos+1]=='^' ? 2 : 3));
+        if (!(ss >> n >> minus >> one) || !n || minus!='-' || one!='1')
+            return false;
+        if (std::numeric_limits<uintT>::is_bounded && n > unsigned(std::numeric_limits<uintT>::digits))
+            return false;
+        val = ((uintT(1)<<(n-1))-uintT(1))*uintT(2)+uintT(1);
+        bool prime = n > 2;
+        for (unsigned d=2; prime && d*d<=n; d++)
+            prime = n % d != 0;
+        if (modulus && prime)
+            *modulus = 2ul*n;
+    } else if (!(ss >> val)) {
+        return false;
+    }
     while (!ss.eof()) {
         char c;
         if (ss >> c)
-            return -1; // non-whitespace remained
+            return false; // non-whitespace remained
     }
-    PrimeFactorizer<uintT,fltT> pf(val);
+    return true;
+}
+
+
+template <typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+int PrintFactorsOf(const std::string& str)
+//-----------------------------------------------------------------------------
+{
+    uintT val = 0;
+    unsigned long modulus;
+    if (!ParseNumber(str, val, &modulus))
+        return -1;
+    PrimeFactorizer<uintT,fltT> pf(val, 0, modulus);
     std::cout << val << " == " << pf << std::endl;
     return 0;
 }
@@ -96,22 +143,109 @@ int main_args(int argc, char* const argv[])
     return -err;
 }
 
+template <typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+bool StreamLine(const std::string& line, double maxSeconds, std::string& result)
+//  one line of the stream format, false for an error
+//-----------------------------------------------------------------------------
+{
+    std::ostringstream os;
+    uintT val = 0;
+    unsigned long modulus;
+    if (!ParseNumber(line, val, &modulus)) {
+        result = line + " error";
+        return false;
+    }
+    PrimeFactorizer<uintT,fltT> pf(val, maxSeconds, modulus);
+    os << val << (pf.Complete() ? " ok" : " timeout");
+    for (unsigned pidx=0; pidx<pf.Primes().size(); pidx++) {
+        os << " " << pf.Primes()[pidx];
+        if (pf.Orders()[pidx] > uintT(1))
+            os << "^" << pf.Orders()[pidx];
+    }
+    if (!pf.Complete())
+        os << " ?" << pf.Cofactor();
+    result = os.str();
+    return true;
+}
+
+template <typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+int main_stream(std::istream& is, unsigned numThreads, double maxSeconds)
+//  factors a batch of lines on the threads, then prints it in order.
+//  Empty lines and lines from # on are skipped.
+//-----------------------------------------------------------------------------
+{
+    if (!numThreads)
+        numThreads = std::thread::hardware_concurrency();
+    if (!numThreads)
+        numThreads = 1;
+    const unsigned batchSize = 64*numThreads;
+    std::vector<std::string> lines, results;
+    std::vector<char> parsed;
+    int err = 0;
+    while (is) {
+        lines.clear();
+        std::string line;
+        while (lines.size() < batchSize && std::getline(is, line)) {
+            line = line.substr(0, line.find('#'));
+            if (line.find_first_not_of(" \t\r") != std::string::npos)
+                lines.push_back(line);
+        }
+        results.assign(lines.size(), std::string());
+        parsed.assign(lines.size(), 0);
+        std::atomic<unsigned> next(0);
+        std::vector<std::thread> threads;
+        for (unsigned t=0; t<numThreads; t++) {
+            threads.push_back(std::thread([&]() {
+                for (unsigned i; (i = next++) < lines.size(); )
+                    parsed[i] = StreamLine<uintT,fltT>(lines[i], maxSeconds, results[i]);
+            }));
+        }
+        for (unsigned t=0; t<threads.size(); t++)
+            threads[t].join();
+        for (unsigned i=0; i<results.size(); i++) {
+            std::cout << results[i] << "\n";
+            err += !parsed[i];
+        }
+        std::cout.flush();
+    }
+    return -err;
+}
+
 //-----------------------------------------------------------------------------
 int main(int argc, char* const argv[])
 //-----------------------------------------------------------------------------
 {
     int bignum = 0;
+    bool stream = false;
+    const char* fileName = 0;
+    unsigned numThreads = 0;
+    double maxSeconds = 0;
 
 #ifndef _MSC_VER
     int c;
 
-    while ((c = getopt(argc, argv, "b?")) != -1) {
+    while ((c = getopt(argc, argv, "bsf:j:t:?")) != -1) {
         switch (c) {
 #ifdef USING_GMP
             case 'b':
                 bignum = 1;
                 break;
 #endif
+            case 's':
+                stream = true;
+                break;
+            case 'f':
+                stream = true;
+                fileName = optarg;
+                break;
+            case 'j':
+                numThreads = atoi(optarg);
+                break;
+            case 't':
+                maxSeconds = atof(optarg);
+                break;
             case '?':
                 usage(argv[0]);
                 return 0;
@@ -133,6 +267,23 @@ int main(int argc, char* const argv[])
     }
 #endif
 
+    if (stream) {
+        std::ifstream file;
+        if (fileName) {
+            file.open(fileName);
+            if (!file) {
+                std::cerr << "Error opening " << fileName << std::endl;
+                return -1;
+            }
+        }
+        std::istream& is = fileName ? file : std::cin;
+#ifdef USING_GMP
+        if (bignum)
+            return main_stream<mpz_class,mpf_class>(is, numThreads, maxSeconds);
+#endif
+        return main_stream<uintmax_t,long double>(is, numThreads, maxSeconds);
+    }
+
     int interactive = !argc;
     
     if (interactive && !bignum) {
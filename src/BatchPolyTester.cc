@@ -0,0 +1,210 @@
+//=============================================================================
+//  Tests blocks of candidates of orders up to 64, one stage at a time
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "BatchPolyTester.h"
+#include "LFSRPolynomial.h"
+
+// the irreducible polynomials of degree 2 to 4 with x**0, as bit i for
+// x**i, and the m with x**m-1 divisible by them
+static const struct { unsigned m; unsigned poly; } sievePolys[] = {
+    { 3, 0x7 }, { 5, 0x1f }, { 7, 0xb }, { 7, 0xd }, { 15, 0x13 }, { 15, 0x19 }
+};
+static const unsigned numSievePolys = sizeof(sievePolys)/sizeof(sievePolys[0]);
+static const unsigned sieveMs[] = { 3, 5, 7, 15 };
+
+
+//-----------------------------------------------------------------------------
+static unsigned SmallMod(unsigned a, unsigned m)
+//  a mod m, both bit i for x**i
+//-----------------------------------------------------------------------------
+{
+    int dm = 31;
+    while (!((m >> dm) & 1))
+        dm--;
+    for (int d=31; d>=dm; d--) {
+        if ((a >> d) & 1)
+            a ^= m << (d-dm);
+    }
+    return a;
+}
+
+//-----------------------------------------------------------------------------
+static const std::vector<char>& SieveTable(void)
+//  bit k of entry r (of 2**15 per m) is set if sieve poly k divides the
+//  residue r mod x**m-1
+//-----------------------------------------------------------------------------
+{
+    static std::vector<char> table;
+    if (table.empty()) {
+        std::vector<char> t(4 << 15, 0);
+        for (unsigned k=0; k<numSievePolys; k++) {
+            unsigned i = 0;
+            while (sieveMs[i] != sievePolys[k].m)
+                i++;
+            for (unsigned r=0; r < (1u << sievePolys[k].m); r++) {
+                if (!SmallMod(r, sievePolys[k].poly))
+                    t[(i << 15) + r] |= char(1 << k);
+            }
+        }
+        table.swap(t);
+    }
+    return table;
+}
+
+//-----------------------------------------------------------------------------
+BatchPolyTester::BatchPolyTester(unsigned ord, const std::vector<uint64_t>& primes)
+//-----------------------------------------------------------------------------
+:   order(ord), mask(ord < 64 ? (uint64_t(1) << ord) - 1 : ~uint64_t(0)), stats(0)
+{
+    SieveTable();
+    const uint64_t maxLen = mask;
+    if (primes.size() > 1) {
+        for (unsigned i=0; i<primes.size(); i++)
+            exponents.push_back(maxLen / primes[i]);
+    }
+}
+
+//-----------------------------------------------------------------------------
+uint64_t BatchPolyTester::Dual(uint64_t poly) const
+//  x**order * p(1/x): the bits below the top one reversed, and the top one
+//-----------------------------------------------------------------------------
+{
+    const uint64_t top = uint64_t(1) << (order-1);
+    return (PolyReverse64(poly & (top-1)) >> (65-order)) | top;
+}
+
+//-----------------------------------------------------------------------------
+int BatchPolyTester::IsAsymmetric(uint64_t poly) const
+//-----------------------------------------------------------------------------
+{
+    const uint64_t diff = poly ^ Dual(poly);
+    if (!diff)
+        return 0;
+    return (poly >> PolyLowestBit(diff)) & 1 ? -1 : 1;
+}
+
+//-----------------------------------------------------------------------------
+unsigned BatchPolyTester::Sieve(uint64_t* polys, unsigned num) const
+//  p with x**0 is 1 + 2*poly, whose bits are folded down mod x**m-1. The
+//  sieve polynomials are not candidates from BATCH_MIN_ORDER on.
+//-----------------------------------------------------------------------------
+{
+    const std::vector<char>& table = SieveTable();
+    unsigned kept = 0;
+    for (unsigned c=0; c<num; c++) {
+        const uint64_t lo = (polys[c] << 1) | 1, hi = polys[c] >> 63;
+        char divisible = 0;
+        for (unsigned i=0; i<4; i++) {
+            const unsigned m = sieveMs[i];
+            uint64_t fold = hi << (64 % m);  // x**64
+            for (unsigned bit=0; bit<64; bit+=m)
+                fold ^= (lo >> bit) & ((uint64_t(1) << m) - 1);
+            divisible |= table[(i << 15) + unsigned(fold)];
+        }
+        polys[kept] = polys[c];
+        kept += !divisible;
+    }
+    return kept;
+}
+
+//-----------------------------------------------------------------------------
+void BatchPolyTester::Tables(const uint64_t* polys, unsigned num)
+//  table[v*num+c] = v * x**order mod p, for the digits v of 4 bits
+//-----------------------------------------------------------------------------
+{
+    table.resize(16*size_t(num));
+    for (unsigned c=0; c<num; c++) {
+        const uint64_t low = ((polys[c] << 1) | 1) & mask;
+        uint64_t powers[4] = { low, 0, 0, 0 };
+        for (unsigned b=1; b<4; b++)
+            powers[b] = MulX(powers[b-1], low);
+        for (unsigned v=0; v<16; v++) {
+            uint64_t t = 0;
+            for (unsigned b=0; b<4; b++) {
+                if ((v >> b) & 1)
+                    t ^= powers[b];
+            }
+            table[v*size_t(num)+c] = t;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+unsigned BatchPolyTester::Squarings(uint64_t* polys, unsigned num)
+//  all squarings for all candidates, as x**(2**i) = x before i = order
+//  is rare, and the first one is recorded
+//-----------------------------------------------------------------------------
+{
+    Tables(polys, num);
+    xPow.assign(num, 2);
+    std::vector<unsigned char> early(num, 0);
+    for (unsigned i=0; i+1<order; i++) {
+        for (unsigned c=0; c<num; c++) {
+            xPow[c] = Square(xPow[c], &table[c], num);
+            early[c] |= xPow[c] == 2;
+        }
+    }
+    unsigned kept = 0;
+    for (unsigned c=0; c<num; c++) {
+        int result = early[c] ? -1 : 0;
+        if (!result && Square(xPow[c], &table[c], num) != 2)
+            result = -2;
+        if (result && stats)
+            stats->Tested(result);
+        polys[kept] = polys[c];
+        kept += !result;
+    }
+    if (stats) stats->Lap(RunStats::SQUARING);
+    return kept;
+}
+
+//-----------------------------------------------------------------------------
+unsigned BatchPolyTester::Factors(uint64_t* polys, unsigned num)
+//-----------------------------------------------------------------------------
+{
+    Tables(polys, num);
+    unsigned kept = 0;
+    for (unsigned c=0; c<num; c++) {
+        const uint64_t low = ((polys[c] << 1) | 1) & mask;
+        int result = 0;
+        for (unsigned k=0; k<exponents.size() && !result; k++) {
+            const uint64_t e = exponents[k];
+            int bit = 63;
+            while (!((e >> bit) & 1))
+                bit--;
+            uint64_t r = 1;
+            for (; bit>=0; bit--) {
+                r = Square(r, &table[c], num);
+                if ((e >> bit) & 1)
+                    r = MulX(r, low);
+            }
+            if (r == 1)
+                result = -3;
+        }
+        if (stats)
+            stats->Tested(result);
+        polys[kept] = polys[c];
+        kept += !result;
+    }
+    if (stats) stats->Lap(RunStats::FACTORS);
+    return kept;
+}
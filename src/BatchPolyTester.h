@@ -0,0 +1,117 @@
+//=============================================================================
+//  Tests blocks of candidates of orders up to 64, one stage at a time
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#ifndef BatchPolyTester_h
+#define BatchPolyTester_h
+#pragma once
+
+#include "GF2Poly.h"
+#include "RunStats.h"
+
+#include <stdint.h>
+#include <vector>
+
+// the orders of the blocks, the smaller ones go to the other testers
+#define BATCH_MIN_ORDER 5
+#define BATCH_MAX_ORDER 64
+
+// candidates per block
+#define BATCH_DEFAULT_SIZE 4096
+
+
+//-----------------------------------------------------------------------------
+class BatchPolyTester {
+//  The tests of SparsePolyTester, on a block of candidates in an array of
+//  words (mlpolygen notation, bit i for x**(i+1)). Each stage runs over
+//  the whole block and then compacts it to the candidates that passed,
+//  so the loop of a stage stays in the cache, and its iterations are
+//  independent of each other:
+//
+//  Sieve()     divisors of degree 2 to 4, from p mod x**m-1 for m = 3, 5,
+//              7 and 15, as each of them divides one of those
+//  Squarings() x**(2**i) mod p, which must be x at i = order, not before
+//  Factors()   x**((2**order-1)/q) mod p, which must not be 1
+//
+//  The arithmetic is mod p in one word. A product is reduced 4 bits at a
+//  time from the top, with the 16 multiples of x**order mod p, a table
+//  per candidate kept side by side for the block (table[v*size+c]).
+//  The stages return the number of candidates kept at the front; each
+//  counts its rejects in stats (if set) as TestPolynomial() would.
+//-----------------------------------------------------------------------------
+  public:
+    BatchPolyTester(unsigned order, const std::vector<uint64_t>& primes);
+
+    void SetStats(RunStats* s) { stats = s; }
+
+    unsigned Sieve(uint64_t* polys, unsigned num) const;
+    unsigned Squarings(uint64_t* polys, unsigned num);
+    unsigned Factors(uint64_t* polys, unsigned num);
+
+    // the symmetric dual, and LFSRPolynomial::IsAsymmetric()
+    uint64_t Dual(uint64_t poly) const;
+    int IsAsymmetric(uint64_t poly) const;
+
+  private:
+    void Tables(const uint64_t* polys, unsigned num);
+    uint64_t Square(uint64_t a, const uint64_t* t, unsigned stride) const;
+    uint64_t MulX(uint64_t a, uint64_t low) const;
+
+    unsigned order;
+    uint64_t mask;                  // the bits below x**order
+    std::vector<uint64_t> exponents;// (2**order-1)/q
+    std::vector<uint64_t> table;
+    std::vector<uint64_t> xPow;
+    RunStats* stats;
+};
+
+
+//=============================================================================
+//  inline implementation
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+inline uint64_t BatchPolyTester::MulX(uint64_t a, uint64_t low) const
+//  a*x mod p, with low = p - x**order
+//-----------------------------------------------------------------------------
+{
+    const uint64_t carry = (a >> (order-1)) & 1;
+    return ((a << 1) & mask) ^ (low & (0-carry));
+}
+
+//-----------------------------------------------------------------------------
+inline uint64_t BatchPolyTester::Square(uint64_t a, const uint64_t* t, unsigned stride) const
+//  a*a = high*x**order + low, and high*x**order mod p by Horner's rule
+//  on the 4 bit digits of high: r = r*x**4 + digit*x**order, both by
+//  the table, as the top 4 bits of r shift to x**order and above.
+//-----------------------------------------------------------------------------
+{
+    const uint64_t lo = SpreadBits32(a), hi = SpreadBits32(a >> 32);
+    const unsigned n = order;
+    const uint64_t high = n < 64 ? (hi << (64-n)) | (lo >> n) : hi;
+    uint64_t r = 0;
+    for (int shift=((n-2)/4)*4; shift>=0; shift-=4) {
+        r = ((r << 4) & mask) ^ t[(r >> (n-4))*stride] ^ t[((high >> shift) & 15)*stride];
+    }
+    return r ^ (lo & mask);
+}
+
+#endif
@@ -0,0 +1,245 @@
+//=============================================================================
+//  Enumerates all ML polynomials of an order from one of them
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "CosetEnumerator.h"
+
+
+//-----------------------------------------------------------------------------
+static unsigned Parity(uint64_t x)
+//-----------------------------------------------------------------------------
+{
+    x ^= x >> 32;
+    x ^= x >> 16;
+    x ^= x >> 8;
+    x ^= x >> 4;
+    x ^= x >> 2;
+    x ^= x >> 1;
+    return unsigned(x & 1);
+}
+
+//-----------------------------------------------------------------------------
+CosetEnumerator::CosetEnumerator()
+//-----------------------------------------------------------------------------
+:   n(0), mask(0), low(0), done(true)
+{
+}
+
+//-----------------------------------------------------------------------------
+bool CosetEnumerator::Init(unsigned order, uint64_t seed, const std::vector<uint64_t>& pr)
+//-----------------------------------------------------------------------------
+{
+    if (order < 2 || order > 64 || !((seed >> (order-1)) & 1))
+        return false;
+    n = order;
+    mask = order < 64 ? (uint64_t(1) << order) - 1 : ~uint64_t(0);
+    low = ((seed << 1) | 1) & mask;
+
+    primes.clear();
+    for (unsigned i=0; i<pr.size(); i++) {
+        if (pr[i] > 1)
+            primes.push_back(pr[i]);
+    }
+
+    // x**(2i) mod p for the bits of a byte, combined per byte value
+    const unsigned numBytes = (n+7)/8;
+    squares.assign(numBytes*256, 0);
+    uint64_t row = 1;
+    for (unsigned i=0; i<8*numBytes; i++) {
+        uint64_t* table = &squares[(i/8)*256];
+        const unsigned bit = 1u << (i%8);
+        for (unsigned v=bit; v<2*bit; v++)
+            table[v] = table[v-bit] ^ (i<n ? row : 0);
+        row = MulX(MulX(row));
+    }
+
+    a.assign(n+1, 0);
+    done = false;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+uint64_t CosetEnumerator::MulX(uint64_t r) const
+//-----------------------------------------------------------------------------
+{
+    const uint64_t carry = (r >> (n-1)) & 1;
+    return ((r << 1) & mask) ^ (low & (0-carry));
+}
+
+//-----------------------------------------------------------------------------
+uint64_t CosetEnumerator::Square(uint64_t r) const
+//-----------------------------------------------------------------------------
+{
+    uint64_t sq = 0;
+    for (unsigned b=0; r; b++, r>>=8)
+        sq ^= squares[b*256 + (r & 0xFF)];
+    return sq;
+}
+
+//-----------------------------------------------------------------------------
+uint64_t CosetEnumerator::PowX(uint64_t k) const
+//-----------------------------------------------------------------------------
+{
+    uint64_t r = 1;
+    for (int bit=63; bit>=0; bit--) {
+        r = Square(r);
+        if ((k >> bit) & 1)
+            r = MulX(r);
+    }
+    return r;
+}
+
+//-----------------------------------------------------------------------------
+bool CosetEnumerator::NextLeaders(std::vector<uint64_t>& leaders, unsigned maxCount)
+//  the next prenecklace: increment the last 0 and repeat the prefix
+//  before it; it is a necklace when its period i divides n
+//-----------------------------------------------------------------------------
+{
+    leaders.clear();
+    while (!done && leaders.size() < maxCount) {
+        unsigned i = n;
+        while (i && a[i])
+            i--;
+        if (!i) {
+            done = true;
+            break;
+        }
+        a[i] = 1;
+        for (unsigned j=i+1; j<=n; j++)
+            a[j] = a[j-i];
+        if (n % i)
+            continue;
+
+        uint64_t k = 0;
+        for (unsigned j=1; j<=n; j++)
+            k = (k << 1) | a[j];
+        bool coprime = true;
+        for (unsigned p=0; coprime && p<primes.size(); p++)
+            coprime = k % primes[p] != 0;
+        if (coprime)
+            leaders.push_back(k);
+    }
+    return !leaders.empty();
+}
+
+//-----------------------------------------------------------------------------
+uint64_t CosetEnumerator::Leader(uint64_t k) const
+//-----------------------------------------------------------------------------
+{
+    uint64_t leader = k & mask;
+    for (unsigned i=1; i<n; i++) {
+        k = ((k << 1) | (k >> (n-1))) & mask;
+        if (k < leader)
+            leader = k;
+    }
+    return leader;
+}
+
+//-----------------------------------------------------------------------------
+unsigned CosetEnumerator::Decimate(uint64_t k, unsigned bit, uint64_t& c) const
+//  the linear complexity of s(k*t) = the given bit of beta**t, and
+//  its connection polynomial c
+//-----------------------------------------------------------------------------
+{
+    // beta*x**j, combined per nibble, to multiply by beta
+    const uint64_t beta = PowX(k);
+    uint64_t table[16][16];
+    uint64_t row = beta;
+    for (unsigned q=0; q<16; q++) {
+        table[q][0] = 0;
+        for (unsigned b=0; b<4; b++) {
+            const unsigned v0 = 1u << b;
+            for (unsigned v=v0; v<2*v0; v++)
+                table[q][v] = table[q][v-v0] ^ (4*q+b<n ? row : 0);
+            row = MulX(row);
+        }
+    }
+
+    // Berlekamp-Massey over the 2n bits. The connection polynomials
+    // c and b have x**0, so bits 0.. are x**1..
+    uint64_t b = 0, window = 0;
+    unsigned length = 0, m = 1;
+    uint64_t r = 1;
+    c = 0;
+    for (unsigned t=0; t<2*n; t++) {
+        const unsigned s = unsigned(r >> bit) & 1;
+        if (s ^ Parity(c & window)) {
+            const uint64_t prev = c;
+            if (m < 64)
+                c ^= b << m;
+            if (m <= 64)
+                c ^= uint64_t(1) << (m-1);
+            if (2*length <= t) {
+                length = t+1-length;
+                b = prev;
+                m = 1;
+            } else {
+                m++;
+            }
+        } else {
+            m++;
+        }
+        window = (window << 1) | s;
+
+        uint64_t next = 0;
+        for (unsigned q=0; r; q++, r>>=4)
+            next ^= table[q][r & 15];
+        r = next;
+    }
+    return length;
+}
+
+//-----------------------------------------------------------------------------
+uint64_t CosetEnumerator::Polynomial(uint64_t k) const
+//  0 if alpha**k does not have degree n (k not coprime to 2**n-1). Any
+//  bit of beta**t gives its minimal polynomial then, the top one is used.
+//-----------------------------------------------------------------------------
+{
+    uint64_t c;
+    if (Decimate(k, n-1, c) != n)
+        return 0;
+
+    // the minimal polynomial is the reciprocal of c
+    uint64_t poly = uint64_t(1) << (n-1);
+    for (unsigned j=1; j<n; j++)
+        poly |= ((c >> (n-j-1)) & 1) << (j-1);
+    return poly;
+}
+
+//-----------------------------------------------------------------------------
+uint64_t CosetEnumerator::MinimalPolynomial(uint64_t k, unsigned& degree) const
+//  The minimal polynomial m of beta is irreducible, so the bits of beta**t
+//  are either 0 or have m as the minimal polynomial. When beta is in a
+//  subfield, some bits are 0 (those whose trace down to it vanishes),
+//  so they are tried until one is not.
+//-----------------------------------------------------------------------------
+{
+    uint64_t c = 0;
+    degree = 0;
+    for (unsigned bit=n; bit-- && !degree; )
+        degree = Decimate(k, bit, c);
+    if (!degree)
+        return 0;
+    uint64_t poly = uint64_t(1) << (degree-1);
+    for (unsigned j=1; j<degree; j++)
+        poly |= ((c >> (degree-j-1)) & 1) << (j-1);
+    return poly;
+}
@@ -0,0 +1,86 @@
+//=============================================================================
+//  Enumerates all ML polynomials of an order from one of them
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#ifndef CosetEnumerator_h
+#define CosetEnumerator_h
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+
+//-----------------------------------------------------------------------------
+class CosetEnumerator {
+//  If alpha is a root of the ML polynomial p of order n, the ML
+//  polynomials are the minimal polynomials of alpha**k for k coprime to
+//  2**n-1. alpha**k and alpha**(2k) have the same one, so one k of each
+//  cyclotomic coset {k*2**j mod 2**n-1} is taken: the smallest, whose n
+//  bits are the least of their rotations (a necklace). The necklaces are
+//  generated in lexicographic order (Fredricksen, Kessler and Maiorana),
+//  in constant amortized time, so the work is proportional to the
+//  number of ML polynomials, not to the 2**(n-2) candidates.
+//
+//  The minimal polynomial of alpha**k follows from the decimation by k
+//  of the m-sequence of p, s(k*t) = the top bit of x**(k*t) mod p, by
+//  Berlekamp-Massey on its first 2n bits. Coset -k holds the roots of
+//  the reciprocal (the symmetric dual) of the polynomial of coset k.
+//
+//  Polynomials are in mlpolygen notation (bit i for x**(i+1)), for
+//  orders 2 to 64. Init() and NextLeaders() are for one thread,
+//  Polynomial() and Leader() may be called from many at once.
+//-----------------------------------------------------------------------------
+  public:
+    CosetEnumerator();
+
+    // seed must be ML, primes the distinct primes of 2**order-1
+    bool Init(unsigned order, uint64_t seed, const std::vector<uint64_t>& primes);
+    unsigned Order(void) const { return n; }
+
+    // the next coset leaders coprime to 2**n-1 (up to maxCount of them),
+    // in increasing order; false once all have been returned
+    bool NextLeaders(std::vector<uint64_t>& leaders, unsigned maxCount);
+
+    // the minimal polynomial of alpha**k
+    uint64_t Polynomial(uint64_t k) const;
+    // the same for any k, its degree is a divisor of n
+    uint64_t MinimalPolynomial(uint64_t k, unsigned& degree) const;
+    // the leader of the coset of k
+    uint64_t Leader(uint64_t k) const;
+
+  private:
+    uint64_t MulX(uint64_t a) const;
+    uint64_t Square(uint64_t a) const;
+    uint64_t PowX(uint64_t k) const;
+    unsigned Decimate(uint64_t k, unsigned bit, uint64_t& c) const;
+
+    unsigned n;
+    uint64_t mask;          // the n bits of a residue
+    uint64_t low;           // x**n mod p
+    std::vector<uint64_t> squares; // per byte of a residue, 256 entries
+    std::vector<uint64_t> primes;
+
+    // the necklace generation, a[1..n] with a[1] the top bit
+    std::vector<unsigned char> a;
+    bool done;
+};
+
+#endif
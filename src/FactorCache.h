@@ -0,0 +1,198 @@
+//=============================================================================
+//  A thread-safe cache of the prime factors of 2**order-1
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#ifndef FactorCache_h
+#define FactorCache_h
+#pragma once
+
+#include "PrimeFactorizer.h"
+
+#include <algorithm>
+#include <istream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <mutex>
+#include <vector>
+
+
+template<typename uintT=uintmax_t, typename fltT=long double>
+//-----------------------------------------------------------------------------
+class FactorCache {
+//  Factoring 2**order-1 is the expensive part of constructing a tester.
+//  The distinct primes are kept per order, so testers for the same order
+//  can be created cheaply, from any thread. Entries are never removed,
+//  so the references returned stay valid for the life of the cache.
+//  2**d-1 divides 2**order-1 for each divisor d of order, so the primes
+//  of the divisors (cached, or factored first) are divided out, and only
+//  the cofactor left is for the PrimeFactorizer. Sweeps over many orders
+//  share most of their factoring work this way.
+//-----------------------------------------------------------------------------
+  public:
+    FactorCache() {}
+
+    // factors 2**order-1 on first use, without holding the lock
+    const std::vector<uintT>& Primes(unsigned order);
+
+    bool Has(unsigned order) const;
+    void Insert(unsigned order, const std::vector<uintT>& primes);
+
+    // the "N ok P[^E] ..." lines of the stream mode of PrimeFactorizer
+    // for N = 2**n-1 whose factors multiply to N (and fit in uintT),
+    // n from minOrder, other lines are skipped. Returns the number of
+    // orders loaded.
+    int Load(std::istream& is, unsigned minOrder=1);
+
+    // one for the whole process, also used by testers given no primes
+    static FactorCache& Shared(void);
+
+  private:
+    FactorCache(const FactorCache&);
+    FactorCache& operator=(const FactorCache&);
+
+    mutable std::mutex mutex;
+    std::map< unsigned, std::vector<uintT> > table;
+};
+
+
+//=============================================================================
+//  template implementation
+//=============================================================================
+
+template<typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+const std::vector<uintT>& FactorCache<uintT,fltT>::Primes(unsigned order)
+//-----------------------------------------------------------------------------
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        typename std::map< unsigned, std::vector<uintT> >::const_iterator it = table.find(order);
+        if (it != table.end())
+            return it->second;
+    }
+    // 2**order-1 without shifting a 64-bit type by 64
+    uintT rest = ((uintT(1)<<(order-1))-uintT(1))*uintT(2)+uintT(1);
+
+    std::vector<uintT> primes;
+    for (unsigned d=order/2; d>1; d--) {
+        if (order % d)
+            continue;
+        const std::vector<uintT>& sub = Primes(d);
+        for (unsigned i=0; i<sub.size(); i++) {
+            if (sub[i] <= uintT(1) || rest % sub[i] != uintT(0))
+                continue;
+            primes.push_back(sub[i]);
+            do {
+                rest /= sub[i];
+            } while (rest % sub[i] == uintT(0));
+        }
+    }
+    if (primes.empty() || rest > uintT(1)) {
+        // a prime left has 2 of order exactly order, so it is 1 mod order
+        PrimeFactorizer<uintT,fltT> factorizer(rest, 0, order);
+        const std::vector<uintT>& more = factorizer.Primes();
+        if (primes.empty()) {
+            primes = more;
+        } else {
+            for (unsigned i=0; i<more.size(); i++) {
+                if (more[i] > uintT(1))
+                    primes.push_back(more[i]);
+            }
+        }
+    }
+    std::sort(primes.begin(), primes.end());
+
+    // another thread may have been faster, then keep its entry
+    std::lock_guard<std::mutex> lock(mutex);
+    return table.insert(std::make_pair(order, primes)).first->second;
+}
+
+template<typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+bool FactorCache<uintT,fltT>::Has(unsigned order) const
+//-----------------------------------------------------------------------------
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return table.find(order) != table.end();
+}
+
+template<typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+void FactorCache<uintT,fltT>::Insert(unsigned order, const std::vector<uintT>& primes)
+//-----------------------------------------------------------------------------
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    table.insert(std::make_pair(order, primes));
+}
+
+template<typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+int FactorCache<uintT,fltT>::Load(std::istream& is, unsigned minOrder)
+//-----------------------------------------------------------------------------
+{
+    int loaded = 0;
+    std::string line;
+    while (std::getline(is, line)) {
+        std::istringstream ss(line.substr(0, line.find('#')));
+        uintT num;
+        std::string status;
+        if (!(ss >> num >> status) || status != "ok")
+            continue;
+        unsigned order = 0;
+        for (uintT m = num; (m & uintT(1)) != uintT(0); m >>= 1)
+            order++;
+        if (order < minOrder || !order || num != ((uintT(1)<<(order-1))-uintT(1))*uintT(2)+uintT(1))
+            continue;
+
+        std::vector<uintT> primes;
+        uintT product = 1;
+        std::string factor;
+        bool valid = true;
+        while (valid && ss >> factor) {
+            std::replace(factor.begin(), factor.end(), '^', ' ');
+            std::istringstream fs(factor);
+            uintT prime;
+            unsigned power = 1;
+            valid = (fs >> prime) && (fs.eof() || fs >> power) && prime != uintT(0);
+            primes.push_back(prime);
+            while (power--)
+                product *= prime;
+        }
+        if (!valid || product != num)
+            continue;
+        std::sort(primes.begin(), primes.end());
+        Insert(order, primes);
+        loaded++;
+    }
+    return loaded;
+}
+
+template<typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+FactorCache<uintT,fltT>& FactorCache<uintT,fltT>::Shared(void)
+//-----------------------------------------------------------------------------
+{
+    static FactorCache cache;
+    return cache;
+}
+
+#endif
@@ -0,0 +1,418 @@
+//=============================================================================
+//  Polynomials over GF(2) of any degree, and their factorization
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "GF2Factor.h"
+
+#include <algorithm>
+
+// random splitting polynomials tried per equal-degree split
+#define MAX_SPLIT_TRIES 1000
+
+
+//-----------------------------------------------------------------------------
+static bool TestBit(const GF2Words& a, unsigned bit)
+//-----------------------------------------------------------------------------
+{
+    return (bit>>6) < a.size() && ((a[bit>>6] >> (bit&63)) & 1);
+}
+
+//-----------------------------------------------------------------------------
+static void XorShifted(GF2Words& r, const GF2Words& m, unsigned shift)
+//  r += m * x**shift, r must be large enough
+//-----------------------------------------------------------------------------
+{
+    for (unsigned i=0; i<m.size(); i++) {
+        if (m[i])
+            XorAtBit(&r[0], shift+64*i, m[i]);
+    }
+}
+
+//-----------------------------------------------------------------------------
+static GF2Words X(void)
+//-----------------------------------------------------------------------------
+{
+    return GF2Words(1, 2);
+}
+
+//-----------------------------------------------------------------------------
+static void Add(GF2Words& a, const GF2Words& b)
+//-----------------------------------------------------------------------------
+{
+    if (a.size() < b.size())
+        a.resize(b.size(), 0);
+    for (unsigned i=0; i<b.size(); i++)
+        a[i] ^= b[i];
+    PolyTrim(a);
+}
+
+//-----------------------------------------------------------------------------
+static void MulMod(const GF2Words& a, const GF2Words& b, const GF2Words& m, GF2Words& r)
+//-----------------------------------------------------------------------------
+{
+    GF2Words t;
+    PolyMul(a, b, t);
+    PolyDivMod(t, m, 0, r);
+}
+
+//-----------------------------------------------------------------------------
+static void Div(const GF2Words& a, const GF2Words& b, GF2Words& q)
+//  exact division
+//-----------------------------------------------------------------------------
+{
+    GF2Words quot, r;
+    PolyDivMod(a, b, &quot, r);
+    q.swap(quot);
+}
+
+//-----------------------------------------------------------------------------
+static void Derivative(const GF2Words& a, GF2Words& d)
+//  the odd powers, each down by one
+//-----------------------------------------------------------------------------
+{
+    d.assign(a.size(), 0);
+    for (unsigned i=0; i<a.size(); i++)
+        d[i] = (a[i] >> 1) & 0x5555555555555555ull;
+    PolyTrim(d);
+}
+
+//-----------------------------------------------------------------------------
+static void SquareRoot(const GF2Words& a, GF2Words& s)
+//  for a polynomial with only even powers: x**2i becomes x**i
+//-----------------------------------------------------------------------------
+{
+    const int deg = PolyDegree(a);
+    s.assign(deg/128 + 1, 0);
+    for (int i=0; 2*i<=deg; i++) {
+        if (TestBit(a, 2*i))
+            s[i>>6] |= uint64_t(1) << (i&63);
+    }
+    PolyTrim(s);
+}
+
+
+//-----------------------------------------------------------------------------
+int PolyDegree(const GF2Words& a)
+//-----------------------------------------------------------------------------
+{
+    for (unsigned i=unsigned(a.size()); i>0; i--) {
+        if (a[i-1]) {
+            int bit = 63;
+            while (!((a[i-1] >> bit) & 1))
+                bit--;
+            return int(i-1)*64 + bit;
+        }
+    }
+    return -1;
+}
+
+//-----------------------------------------------------------------------------
+void PolyTrim(GF2Words& a)
+//-----------------------------------------------------------------------------
+{
+    while (!a.empty() && !a.back())
+        a.pop_back();
+}
+
+//-----------------------------------------------------------------------------
+bool PolyIsOne(const GF2Words& a)
+//-----------------------------------------------------------------------------
+{
+    if (a.empty() || a[0] != 1)
+        return false;
+    for (unsigned i=1; i<a.size(); i++) {
+        if (a[i])
+            return false;
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void PolyMul(const GF2Words& a, const GF2Words& b, GF2Words& c)
+//  shift and add, for each bit of a
+//-----------------------------------------------------------------------------
+{
+    const int deg = PolyDegree(a);
+    GF2Words r(a.size() + b.size() + 1, 0);
+    for (int bit=0; bit<=deg; bit++) {
+        if (TestBit(a, bit))
+            XorShifted(r, b, bit);
+    }
+    PolyTrim(r);
+    c.swap(r);
+}
+
+//-----------------------------------------------------------------------------
+void PolyDivMod(const GF2Words& a, const GF2Words& m, GF2Words* q, GF2Words& r)
+//  clears the top bits of the remainder from the top down
+//-----------------------------------------------------------------------------
+{
+    const int dm = PolyDegree(m);
+    GF2Words rem(a);
+    rem.push_back(0);
+    int dr = PolyDegree(rem);
+    if (q)
+        q->assign(dr>=dm ? (dr-dm)/64+1 : 0, 0);
+    for (; dr>=dm; dr--) {
+        if (!TestBit(rem, dr))
+            continue;
+        XorShifted(rem, m, dr-dm);
+        if (q)
+            (*q)[(dr-dm)>>6] |= uint64_t(1) << ((dr-dm)&63);
+    }
+    PolyTrim(rem);
+    r.swap(rem);
+    if (q)
+        PolyTrim(*q);
+}
+
+//-----------------------------------------------------------------------------
+void PolyGcd(const GF2Words& a, const GF2Words& b, GF2Words& g)
+//-----------------------------------------------------------------------------
+{
+    GF2Words u(a), v(b), r;
+    PolyTrim(u);
+    PolyTrim(v);
+    while (!v.empty()) {
+        PolyDivMod(u, v, 0, r);
+        u.swap(v);
+        v.swap(r);
+    }
+    g.swap(u);
+}
+
+//-----------------------------------------------------------------------------
+void PolyPowXMod(const GF2Words& f, const GF2Words& k, GF2Words& r)
+//  by squaring and multiplying by x, with the sparse reduction of
+//  GF2Modulus, from the top bit of k down
+//-----------------------------------------------------------------------------
+{
+    const int n = PolyDegree(f);
+    std::vector<unsigned> taps;
+    for (int j=0; j<n; j++) {
+        if (TestBit(f, j))
+            taps.push_back(j);
+    }
+    GF2Modulus mod(n);
+    mod.SetTaps(taps);
+    mod.One(r);
+    for (unsigned bit=unsigned(k.size())*64; bit>0; bit--) {
+        mod.Square(r);
+        if (TestBit(k, bit-1))
+            mod.MulX(r);
+    }
+    PolyTrim(r);
+}
+
+//-----------------------------------------------------------------------------
+std::string PolyToHex(const GF2Words& p)
+//-----------------------------------------------------------------------------
+{
+    static const char digits[] = "0123456789abcdef";
+    const int deg = PolyDegree(p);
+    std::string hex;
+    for (int k=(deg-1)/4; k>=0; k--) {
+        unsigned digit = 0;
+        for (unsigned bit=0; bit<4; bit++)
+            digit |= unsigned(TestBit(p, 4*k+bit+1)) << bit;
+        if (digit || !hex.empty())
+            hex += digits[digit];
+    }
+    return hex.empty() ? "0" : hex;
+}
+
+
+//-----------------------------------------------------------------------------
+static void SquareFree(const GF2Words& f, unsigned mult, std::vector<GF2Factor>& parts)
+//  f as the product of square-free parts to the power of their mult.
+//  In GF(2) the derivative of a square is zero, so the square parts
+//  left over are handled by their square root.
+//-----------------------------------------------------------------------------
+{
+    GF2Words d, c, w;
+    Derivative(f, d);
+    if (d.empty()) {
+        SquareRoot(f, c);
+        SquareFree(c, 2*mult, parts);
+        return;
+    }
+    PolyGcd(f, d, c);
+    Div(f, c, w);
+    for (unsigned i=1; !PolyIsOne(w); i++) {
+        GF2Words y, z;
+        PolyGcd(w, c, y);
+        Div(w, y, z);
+        if (!PolyIsOne(z)) {
+            GF2Factor part = { z, i*mult };
+            parts.push_back(part);
+        }
+        w.swap(y);
+        Div(c, w, y);
+        c.swap(y);
+    }
+    if (!PolyIsOne(c)) {
+        GF2Words s;
+        SquareRoot(c, s);
+        SquareFree(s, 2*mult, parts);
+    }
+}
+
+//-----------------------------------------------------------------------------
+static void EqualDegree(const GF2Words& t, int d, unsigned mult, uint64_t& seed, std::vector<GF2Factor>& factors)
+//  t is a product of irreducibles of degree d. A random a splits it with
+//  probability about 1/2: the trace a + a**2 + .. + a**(2**(d-1)) is 0 or 1
+//  modulo each factor.
+//-----------------------------------------------------------------------------
+{
+    const int deg = PolyDegree(t);
+    if (deg <= d) {
+        GF2Factor factor = { t, mult };
+        factors.push_back(factor);
+        return;
+    }
+    for (unsigned tries=0; tries<MAX_SPLIT_TRIES; tries++) {
+        GF2Words a(t.size(), 0);
+        for (unsigned i=0; i<a.size(); i++) {
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            a[i] = seed;
+        }
+        PolyDivMod(a, t, 0, a);
+
+        GF2Words trace(a), g;
+        for (int i=1; i<d; i++) {
+            MulMod(a, a, t, a);
+            Add(trace, a);
+        }
+        PolyGcd(t, trace, g);
+        const int dg = PolyDegree(g);
+        if (dg > 0 && dg < deg) {
+            GF2Words h;
+            Div(t, g, h);
+            EqualDegree(g, d, mult, seed, factors);
+            EqualDegree(h, d, mult, seed, factors);
+            return;
+        }
+    }
+    GF2Factor factor = { t, mult }; // not reached in practice
+    factors.push_back(factor);
+}
+
+//-----------------------------------------------------------------------------
+static bool FactorLess(const GF2Factor& a, const GF2Factor& b)
+//-----------------------------------------------------------------------------
+{
+    const int da = PolyDegree(a.poly), db = PolyDegree(b.poly);
+    if (da != db)
+        return da < db;
+    for (unsigned i=unsigned(a.poly.size()); i>0; i--) {
+        if (a.poly[i-1] != b.poly[i-1])
+            return a.poly[i-1] < b.poly[i-1];
+    }
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+void PolyFactor(const GF2Words& p, std::vector<GF2Factor>& factors)
+//-----------------------------------------------------------------------------
+{
+    factors.clear();
+    GF2Words f(p);
+    PolyTrim(f);
+    if (PolyDegree(f) < 1)
+        return;
+
+    // x itself is split off first, the rest has x**0
+    unsigned numX = 0;
+    while (!TestBit(f, numX))
+        numX++;
+    if (numX) {
+        GF2Factor factor = { X(), numX };
+        factors.push_back(factor);
+        GF2Words xs(numX/64+1, 0);
+        xs[numX>>6] = uint64_t(1) << (numX&63);
+        Div(f, xs, f);
+    }
+
+    std::vector<GF2Factor> parts;
+    if (PolyDegree(f) > 0)
+        SquareFree(f, 1, parts);
+
+    uint64_t seed = 0x9E3779B97F4A7C15ull;
+    for (unsigned k=0; k<parts.size(); k++) {
+        // distinct degree: the factors of degree d divide x**(2**d) - x
+        GF2Words g(parts[k].poly), h, t;
+        PolyDivMod(X(), g, 0, h);
+        for (int d=1; 2*d <= PolyDegree(g); d++) {
+            MulMod(h, h, g, h);
+            GF2Words hx(h);
+            Add(hx, X());
+            PolyGcd(g, hx, t);
+            if (!PolyIsOne(t)) {
+                EqualDegree(t, d, parts[k].multiplicity, seed, factors);
+                Div(g, t, g);
+                PolyDivMod(h, g, 0, h);
+            }
+        }
+        if (PolyDegree(g) > 0) {
+            GF2Factor factor = { g, parts[k].multiplicity };
+            factors.push_back(factor);
+        }
+    }
+    std::sort(factors.begin(), factors.end(), FactorLess);
+}
+
+//-----------------------------------------------------------------------------
+bool TrinomialHasEvenFactors(unsigned n, unsigned k)
+//  Swan's theorem, for exactly one of n and k odd, the other cases by
+//  symmetry: x**n+x**(n-k)+1 is the reciprocal, with as many factors,
+//  and when both are even it is a square.
+//-----------------------------------------------------------------------------
+{
+    if (n % 2 == 0 && k % 2 == 0)
+        return true;
+    if (n % 2 && k % 2)
+        k = n-k;
+    const unsigned n8 = n % 8;
+    if (n % 2 == 0)
+        return n != 2*k && (uint64_t(n/2)*k % 4 <= 1);
+    if ((2*n) % k)
+        return n8 == 3 || n8 == 5;
+    return n8 == 1 || n8 == 7;
+}
+
+//-----------------------------------------------------------------------------
+bool IsMersenneExponent(unsigned n)
+//  all of them below 2**32 that are known, to 2024
+//-----------------------------------------------------------------------------
+{
+    static const unsigned exponents[] = {
+        2, 3, 5, 7, 13, 17, 19, 31, 61, 89, 107, 127, 521, 607, 1279, 2203,
+        2281, 3217, 4253, 4423, 9689, 9941, 11213, 19937, 21701, 23209,
+        44497, 86243, 110503, 132049, 216091, 756839, 859433, 1257787,
+        1398269, 2976221, 3021377, 6972593, 13466917, 20996011, 24036583,
+        25964951, 30402457, 32582657, 37156667, 42643801, 43112609,
+        57885161, 74207281, 77232917, 82589933, 136279841
+    };
+    const unsigned num = sizeof(exponents)/sizeof(exponents[0]);
+    return std::binary_search(exponents, exponents+num, n);
+}
@@ -0,0 +1,71 @@
+//=============================================================================
+//  Polynomials over GF(2) of any degree, and their factorization
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#ifndef GF2Factor_h
+#define GF2Factor_h
+#pragma once
+
+#include "GF2Poly.h"
+
+#include <string>
+#include <vector>
+
+//  Polynomials are GF2Words, bit i for x**i, without high zero words
+//  (the zero polynomial has none). The modulus does not need to be
+//  sparse, unlike for GF2Modulus.
+
+int PolyDegree(const GF2Words& a);      // -1 for zero
+void PolyTrim(GF2Words& a);
+bool PolyIsOne(const GF2Words& a);
+
+void PolyMul(const GF2Words& a, const GF2Words& b, GF2Words& c);
+// q (if given) and r with a = q*m + r, m not zero
+void PolyDivMod(const GF2Words& a, const GF2Words& m, GF2Words* q, GF2Words& r);
+void PolyGcd(const GF2Words& a, const GF2Words& b, GF2Words& g);
+
+// x**k mod f, k as little endian words of a number, f with x**0
+void PolyPowXMod(const GF2Words& f, const GF2Words& k, GF2Words& r);
+
+// mlpolygen notation: bit i for x**(i+1), x**0 dropped
+std::string PolyToHex(const GF2Words& p);
+
+
+//-----------------------------------------------------------------------------
+struct GF2Factor {
+//-----------------------------------------------------------------------------
+    GF2Words poly;          // irreducible
+    unsigned multiplicity;
+};
+
+// the irreducible factors of p, by degree and then value. Square-free
+// factorization, distinct-degree factorization, and the equal-degree
+// splitting of Cantor and Zassenhaus (by the trace map in GF(2)).
+void PolyFactor(const GF2Words& p, std::vector<GF2Factor>& factors);
+
+// Swan's theorem: whether x**n + x**k + 1 (0<k<n) has an even number of
+// irreducible factors, counted with multiplicity, so it is reducible
+bool TrinomialHasEvenFactors(unsigned n, unsigned k);
+
+// whether 2**n-1 is a known Mersenne prime
+bool IsMersenneExponent(unsigned n);
+
+#endif
@@ -0,0 +1,197 @@
+//=============================================================================
+//  Word-level arithmetic on polynomials over GF(2), modulo a tap list
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#ifndef GF2Poly_h
+#define GF2Poly_h
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
+
+// bit i of the words is the coefficient of x**i
+typedef std::vector<uint64_t> GF2Words;
+
+
+//-----------------------------------------------------------------------------
+inline uint64_t SpreadBits32(uint64_t x)
+//  moves bit i of a 32 bit value to bit 2*i, which squares it over GF(2)
+//-----------------------------------------------------------------------------
+{
+    x &= 0xFFFFFFFFull;
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+    x = (x | (x <<  8)) & 0x00FF00FF00FF00FFull;
+    x = (x | (x <<  4)) & 0x0F0F0F0F0F0F0F0Full;
+    x = (x | (x <<  2)) & 0x3333333333333333ull;
+    x = (x | (x <<  1)) & 0x5555555555555555ull;
+    return x;
+}
+
+//-----------------------------------------------------------------------------
+inline void XorAtBit(uint64_t* w, unsigned bitpos, uint64_t val)
+//  xor a 64 bit value into the words, with its bit 0 at bitpos. The next
+//  word is only touched when bits land there.
+//-----------------------------------------------------------------------------
+{
+    unsigned idx = bitpos>>6, sh = bitpos&63;
+    w[idx] ^= val << sh;
+    if (sh && (val >> (64-sh)))
+        w[idx+1] ^= val >> (64-sh);
+}
+
+
+//-----------------------------------------------------------------------------
+class GF2Modulus {
+//  arithmetic modulo p(x) = x**n + (sum of x**t over the taps t<n).
+//  Reduction is a shift-XOR per tap, so its cost is proportional to
+//  the number of taps, which makes it cheap for sparse polynomials.
+//  Not thread-safe: it owns its scratch space.
+//-----------------------------------------------------------------------------
+  public:
+    GF2Modulus(unsigned degree=1);
+
+    void SetTaps(const std::vector<unsigned>& taps); // exponents below degree
+
+    unsigned Degree(void) const { return n; }
+    unsigned Words(void) const { return numWords; }
+    const std::vector<unsigned>& Taps(void) const { return taps; }
+
+    void Zero(GF2Words& a) const { a.assign(numWords, 0); }
+    void One(GF2Words& a) const { Zero(a); a[0] = 1; }
+    void X(GF2Words& a) const { Zero(a); SetBit(a, 1); }
+    void SetBit(GF2Words& a, unsigned bit) const;
+
+    void Square(GF2Words& a);                  // a = a*a mod p
+    void MulX(GF2Words& a) const;              // a = a*x mod p
+    void Mul(GF2Words& a, const GF2Words& b);  // a = a*b mod p
+
+    void Reduce(uint64_t* t, unsigned tWords) const; // in place, any length
+
+  private:
+    unsigned n;
+    unsigned numWords;
+    std::vector<unsigned> taps;
+    GF2Words scratch;
+};
+
+
+//=============================================================================
+//  inline implementation
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+inline GF2Modulus::GF2Modulus(unsigned degree)
+//-----------------------------------------------------------------------------
+:   n(degree), numWords((degree+64)/64)
+{
+    taps.push_back(0);
+}
+
+//-----------------------------------------------------------------------------
+inline void GF2Modulus::SetTaps(const std::vector<unsigned>& t)
+//-----------------------------------------------------------------------------
+{
+    taps = t;
+}
+
+//-----------------------------------------------------------------------------
+inline void GF2Modulus::SetBit(GF2Words& a, unsigned bit) const
+//  values of degree n are reduced, so x**1 is fine even for n==1
+//-----------------------------------------------------------------------------
+{
+    a[bit>>6] |= uint64_t(1) << (bit&63);
+    if (bit >= n)
+        Reduce(&a[0], numWords);
+}
+
+//-----------------------------------------------------------------------------
+inline void GF2Modulus::Reduce(uint64_t* t, unsigned tWords) const
+//  processes the words holding bits >= n from the top down. Each chunk
+//  of high bits is cleared and xored back in, shifted down by n-tap,
+//  once per tap. When that lands in the same word above n, repeat.
+//-----------------------------------------------------------------------------
+{
+    const unsigned nWord = n>>6, nBit = n&63;
+    for (unsigned w=tWords-1; w+1>nWord && w<tWords; w--) {
+        while (1) {
+            uint64_t chunk;
+            unsigned base;
+            if (w > nWord) {
+                chunk = t[w];
+                base = w*64;
+                t[w] = 0;
+            } else {
+                chunk = t[w] >> nBit;
+                base = n;
+                t[w] &= (uint64_t(1) << nBit) - 1; // nBit<64 here
+            }
+            if (!chunk)
+                break;
+            for (unsigned k=0; k<taps.size(); k++) {
+                XorAtBit(t, base-n+taps[k], chunk);
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+inline void GF2Modulus::Square(GF2Words& a)
+//-----------------------------------------------------------------------------
+{
+    scratch.assign(2*numWords+1, 0);
+    for (unsigned w=0; w<numWords; w++) {
+        scratch[2*w]   = SpreadBits32(a[w]);
+        scratch[2*w+1] = SpreadBits32(a[w]>>32);
+    }
+    Reduce(&scratch[0], 2*numWords);
+    std::copy(scratch.begin(), scratch.begin()+numWords, a.begin());
+}
+
+//-----------------------------------------------------------------------------
+inline void GF2Modulus::MulX(GF2Words& a) const
+//-----------------------------------------------------------------------------
+{
+    for (unsigned w=numWords-1; w>0; w--)
+        a[w] = (a[w] << 1) | (a[w-1] >> 63);
+    a[0] <<= 1;
+    Reduce(&a[0], numWords);
+}
+
+//-----------------------------------------------------------------------------
+inline void GF2Modulus::Mul(GF2Words& a, const GF2Words& b)
+//  schoolbook shift and add, with a reduction at the end
+//-----------------------------------------------------------------------------
+{
+    scratch.assign(2*numWords+1, 0);
+    for (unsigned bit=0; bit<n; bit++) {
+        if (!((a[bit>>6] >> (bit&63)) & 1))
+            continue;
+        for (unsigned w=0; w<numWords; w++) {
+            if (b[w])
+                XorAtBit(&scratch[0], bit+64*w, b[w]);
+        }
+    }
+    Reduce(&scratch[0], 2*numWords);
+    std::copy(scratch.begin(), scratch.begin()+numWords, a.begin());
+}
+
+#endif
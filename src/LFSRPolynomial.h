@@ -26,10 +26,52 @@
 
 #include <bitset>
 #include <iostream>
+#include <stdint.h>
+#include <string.h>
 
 
 typedef std::bitset<64> default_poly_t;
 
+
+//-----------------------------------------------------------------------------
+inline unsigned PolyPopCount(uint64_t x)
+//-----------------------------------------------------------------------------
+{
+#if defined(__GNUC__)
+    return __builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ull);
+    x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return unsigned((x * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+//-----------------------------------------------------------------------------
+inline unsigned PolyLowestBit(uint64_t x)
+//  the index of the lowest bit set, x must not be 0
+//-----------------------------------------------------------------------------
+{
+#if defined(__GNUC__)
+    return unsigned(__builtin_ctzll(x));
+#else
+    return PolyPopCount((x & (0-x)) - 1);
+#endif
+}
+
+//-----------------------------------------------------------------------------
+inline uint64_t PolyReverse64(uint64_t x)
+//  bit i moves to bit 63-i
+//-----------------------------------------------------------------------------
+{
+    x = ((x >> 1) & 0x5555555555555555ull) | ((x & 0x5555555555555555ull) << 1);
+    x = ((x >> 2) & 0x3333333333333333ull) | ((x & 0x3333333333333333ull) << 2);
+    x = ((x >> 4) & 0x0F0F0F0F0F0F0F0Full) | ((x & 0x0F0F0F0F0F0F0F0Full) << 4);
+    x = ((x >> 8) & 0x00FF00FF00FF00FFull) | ((x & 0x00FF00FF00FF00FFull) << 8);
+    x = ((x >> 16) & 0x0000FFFF0000FFFFull) | ((x & 0x0000FFFF0000FFFFull) << 16);
+    return (x >> 32) | (x << 32);
+}
+
 template<typename poly_t=default_poly_t>
 //-----------------------------------------------------------------------------
 class LFSRPolynomial {
@@ -60,8 +102,22 @@ class LFSRPolynomial {
     // iterator-like for iterating over potential candidates
     const LFSRPolynomial<poly_t>& next_candidate(void);
     bool end_candidate(void) const;
+
+    // the same, but only visiting candidates with minTaps..maxTaps bits set
+    const LFSRPolynomial<poly_t>& next_candidate(unsigned minTaps, unsigned maxTaps);
+    bool is_candidate(unsigned minTaps, unsigned maxTaps) const;
     
   protected:
+    bool AddBit(unsigned n); // add 2**n, false on overflow
+
+    // the bits below numBits as 64 bit words, bit i of the polynomial
+    // is bit i%64 of word i/64; NumWords() of them are used
+    enum { maxWords = (sizeof(poly_t)*8+63)/64 };
+    unsigned NumWords(void) const { return (numBits+63)/64; }
+    void ToWords(uint64_t* words) const;
+    void FromWords(const uint64_t* words);
+    void DualWords(const uint64_t* words, uint64_t* dual) const;
+
     poly_t   poly;
     unsigned numBits;
 };
@@ -128,16 +184,93 @@ LFSRPolynomial<poly_t>::LFSRPolynomial(const std::string& s)
     assert(numBits<=poly.size());
 }
 
+template<typename poly_t>
+//-----------------------------------------------------------------------------
+void LFSRPolynomial<poly_t>::ToWords(uint64_t* words) const
+//  a std::bitset keeps its bits in an array of words, lowest first, so on
+//  a little-endian host its bytes are those of the uint64_t words
+//-----------------------------------------------------------------------------
+{
+    const unsigned numWords = NumWords();
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    uint64_t all[maxWords] = {0};
+    memcpy(all, &poly, sizeof(poly));
+    memcpy(words, all, numWords*sizeof(uint64_t));
+#else
+    for (unsigned w=0; w<numWords; w++)
+        words[w] = 0;
+    for (unsigned i=0; i<numBits; i++) {
+        if (poly[i])
+            words[i/64] |= uint64_t(1) << (i%64);
+    }
+#endif
+    if (numBits%64)
+        words[numWords-1] &= (uint64_t(1) << (numBits%64)) - 1;
+}
+
+template<typename poly_t>
+//-----------------------------------------------------------------------------
+void LFSRPolynomial<poly_t>::FromWords(const uint64_t* words)
+//  the bits at and above numBits are cleared
+//-----------------------------------------------------------------------------
+{
+    const unsigned numWords = NumWords();
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    uint64_t all[maxWords] = {0};
+    memcpy(all, words, numWords*sizeof(uint64_t));
+    if (numBits%64)
+        all[numWords-1] &= (uint64_t(1) << (numBits%64)) - 1;
+    memcpy(&poly, all, sizeof(poly));
+#else
+    poly = 0;
+    for (unsigned i=0; i<numBits; i++)
+        poly.set(i, (words[i/64] >> (i%64)) & 1);
+#endif
+}
+
+template<typename poly_t>
+//-----------------------------------------------------------------------------
+void LFSRPolynomial<poly_t>::DualWords(const uint64_t* words, uint64_t* dual) const
+//  bits 0..numBits-2 reversed, with the top bit set: all words are
+//  reversed, then shifted down by the unused bits above numBits-1
+//-----------------------------------------------------------------------------
+{
+    const unsigned numWords = NumWords();
+    uint64_t rev[maxWords+1];
+    for (unsigned w=0; w<numWords; w++)
+        rev[w] = PolyReverse64(words[numWords-1-w]);
+    rev[numWords] = 0;
+    const unsigned top = 64*numWords - numBits; // where the top bit went
+    rev[0] = top < 63 ? rev[0] & (~uint64_t(0) << (top+1)) : 0;
+
+    const unsigned shift = top+1;
+    const unsigned ws = shift/64, bs = shift%64;
+    for (unsigned w=0; w<numWords; w++) {
+        const uint64_t lo = w+ws < numWords ? rev[w+ws] : 0;
+        const uint64_t hi = rev[w+ws+1 <= numWords ? w+ws+1 : numWords];
+        dual[w] = bs ? (lo >> bs) | (hi << (64-bs)) : lo;
+    }
+    dual[(numBits-1)/64] |= uint64_t(1) << ((numBits-1)%64);
+}
+
 template<typename poly_t>
 //-----------------------------------------------------------------------------
 void LFSRPolynomial<poly_t>::printAsHex(std::ostream& os) const
+//  one digit per nibble from the words, written at once
 //-----------------------------------------------------------------------------
 {
-    os << std::hex;
-    for (int i=(numBits-1)&(-4); i>=0; i-=4) {
-        int nibble = poly[i] + poly[i+1]*2 + poly[i+2]*4 + poly[i+3]*8;
-        os << nibble;
+    static const char digits[] = "0123456789abcdef";
+    uint64_t words[maxWords];
+    ToWords(words);
+
+    const unsigned numDigits = (numBits+3)/4;
+    char text[maxWords*16];
+    for (unsigned d=0; d<numDigits; d++) {
+        const unsigned i = 4*(numDigits-1-d);
+        text[d] = digits[(words[i/64] >> (i%64)) & 15];
     }
+    os << std::hex;
+    os.write(text, numDigits);
 }
 
 template<typename poly_t>
@@ -158,11 +291,11 @@ unsigned LFSRPolynomial<poly_t>::NumBitsSet(void) const
 //  returns the number of bits set to 1 in this polynomial
 //-----------------------------------------------------------------------------
 {
+    uint64_t words[maxWords];
+    ToWords(words);
     unsigned result = 0;
-    for (unsigned i=0; i<numBits; i++) {
-        if ( poly[i] )
-            result++;
-    }
+    for (unsigned w=0; w<NumWords(); w++)
+        result += PolyPopCount(words[w]);
     return result;
 }
 
@@ -173,12 +306,18 @@ int LFSRPolynomial<poly_t>::IsAsymmetric(void) const
 //  non-zero indicates it is asymmetric
 //  -1 indicates it has extra bit(s) set in LSBs
 //  1 indicates it has extra bit(s) set in MSBs
+//  The lowest bit that differs from the dual decides.
 //-----------------------------------------------------------------------------
-{   
-    for (int i=1; i <= numBits/2; i++) {
-        // if symmetric, bits are equal
-        if ( poly[i-1] == poly[numBits-i-1] ) continue;
-        else return poly[i-1] ? -1 : 1;
+{
+    if (numBits < 2)
+        return 0;
+    uint64_t words[maxWords], dual[maxWords];
+    ToWords(words);
+    DualWords(words, dual);
+    for (unsigned w=0; w<NumWords(); w++) {
+        const uint64_t diff = words[w] ^ dual[w];
+        if (diff)
+            return (words[w] >> PolyLowestBit(diff)) & 1 ? -1 : 1;
     }
     return 0;
 }
@@ -190,12 +329,13 @@ LFSRPolynomial<poly_t> LFSRPolynomial<poly_t>::SymmetricDual(void) const
 //-----------------------------------------------------------------------------
 {
     LFSRPolynomial<poly_t> result(numBits);
-    
-    for (int i=1; i <= numBits/2; i++) {
-        result.poly[i-1] = poly[numBits-i-1];
-        result.poly[numBits-i-1] = poly[i-1];
-    }
-    
+    if (numBits < 2)
+        return result;
+
+    uint64_t words[maxWords], dual[maxWords];
+    ToWords(words);
+    DualWords(words, dual);
+    result.FromWords(dual);
     return result;
 }
 
@@ -247,16 +387,16 @@ template<typename poly_t>
 //-----------------------------------------------------------------------------
 bool LFSRPolynomial<poly_t>::operator<(const LFSRPolynomial<poly_t>& lp) const
 //-----------------------------------------------------------------------------
-// true if this < lp
+// true if this < lp, comparing the most significant words first
 {
     if (numBits != lp.numBits)
         return numBits < lp.numBits;
-    unsigned i=numBits;
-    for (; i; i--) {
-        bool A = operator[](i-1);
-        bool B = lp[i-1];
-        if (A != B)
-            return A<B;
+    uint64_t a[maxWords], b[maxWords];
+    ToWords(a);
+    lp.ToWords(b);
+    for (unsigned w=NumWords(); w; w--) {
+        if (a[w-1] != b[w-1])
+            return a[w-1] < b[w-1];
     }
     return false;
 }
@@ -295,4 +435,62 @@ bool LFSRPolynomial<poly_t>::end_candidate(void) const
     return tmp == poly;
 }
 
+template<typename poly_t>
+//-----------------------------------------------------------------------------
+bool LFSRPolynomial<poly_t>::AddBit(unsigned n)
+//  ripple-carry addition of 2**n, false if it carries out of numBits
+//-----------------------------------------------------------------------------
+{
+    while (n < numBits && poly[n]) {
+        poly.set(n,0);
+        n++;
+    }
+    if (n >= numBits)
+        return false;
+    poly.set(n,1);
+    return true;
+}
+
+template<typename poly_t>
+//-----------------------------------------------------------------------------
+bool LFSRPolynomial<poly_t>::is_candidate(unsigned minTaps, unsigned maxTaps) const
+//-----------------------------------------------------------------------------
+{
+    const unsigned numTaps = NumBitsSet();
+    return !(numTaps & 1) && minTaps <= numTaps && numTaps <= maxTaps;
+}
+
+template<typename poly_t>
+//-----------------------------------------------------------------------------
+const LFSRPolynomial<poly_t>& LFSRPolynomial<poly_t>::next_candidate(unsigned minTaps, unsigned maxTaps)
+//  the smallest candidate larger than this one with an even number
+//  of bits set, from minTaps to maxTaps. Each step below moves to the
+//  smallest value not ruled out by the current bit count:
+//  too many bits: add the lowest set bit, clearing its run of ones;
+//  too few bits: set the lowest clear bit; odd count: add one.
+//-----------------------------------------------------------------------------
+{
+    if (end_candidate()) return *this;
+
+    bool ok = AddBit(0);
+    while (ok) {
+        const unsigned numTaps = NumBitsSet();
+        unsigned bit = 0;
+        if (numTaps > maxTaps) {
+            while (!poly[bit]) bit++;
+            ok = AddBit(bit);
+        } else if (numTaps < minTaps) {
+            while (bit < numBits && poly[bit]) bit++;
+            ok = bit < numBits;
+            if (ok) poly.set(bit,1);
+        } else if (numTaps & 1) {
+            ok = AddBit(0);
+        } else {
+            return *this;
+        }
+    }
+    poly = 0; // end case
+    return *this;
+}
+
 #endif
@@ -0,0 +1,602 @@
+//=============================================================================
+//  Generates the output bit sequence of an LFSR, many steps at a time
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "LFSRSequence.h"
+#include "GF2Factor.h"
+
+#include <string.h>
+
+// words in the output window of higher orders, beyond the order itself
+#define WINDOW_EXTRA_WORDS 1024
+
+
+//-----------------------------------------------------------------------------
+static unsigned Parity(uint64_t x)
+//-----------------------------------------------------------------------------
+{
+    x ^= x >> 32;
+    x ^= x >> 16;
+    x ^= x >> 8;
+    x ^= x >> 4;
+    x ^= x >> 2;
+    x ^= x >> 1;
+    return unsigned(x & 1);
+}
+
+//-----------------------------------------------------------------------------
+static bool GetBit(const GF2Words& w, unsigned bit)
+//-----------------------------------------------------------------------------
+{
+    return (bit>>6) < w.size() && ((w[bit>>6] >> (bit&63)) & 1);
+}
+
+//-----------------------------------------------------------------------------
+static unsigned TopBit(const GF2Words& w)
+//  the position of the highest bit set, 0 for none
+//-----------------------------------------------------------------------------
+{
+    for (unsigned i=unsigned(w.size()); i>0; i--) {
+        if (w[i-1]) {
+            unsigned bit = 63;
+            while (!((w[i-1] >> bit) & 1))
+                bit--;
+            return (i-1)*64 + bit;
+        }
+    }
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+static void ShiftRightOne(GF2Words& w)
+//-----------------------------------------------------------------------------
+{
+    for (unsigned i=0; i<w.size(); i++)
+        w[i] = (w[i] >> 1) | (i+1<w.size() ? w[i+1] << 63 : 0);
+}
+
+//-----------------------------------------------------------------------------
+static uint64_t ExtractBits(const GF2Words& w, uint64_t pos)
+//  64 bits from pos on, zero beyond the words
+//-----------------------------------------------------------------------------
+{
+    const size_t idx = size_t(pos>>6);
+    const unsigned sh = pos&63;
+    uint64_t bits = idx<w.size() ? w[idx] >> sh : 0;
+    if (sh && idx+1<w.size())
+        bits |= w[idx+1] << (64-sh);
+    return bits;
+}
+
+//-----------------------------------------------------------------------------
+static unsigned DotBits(const GF2Words& a, uint64_t from, const GF2Words& b, unsigned n)
+//  the parity of bits from .. from+n-1 of a, and-ed with bits 0 .. n-1 of b
+//-----------------------------------------------------------------------------
+{
+    uint64_t sum = 0;
+    for (unsigned i=0; i<n; i+=64) {
+        uint64_t bits = ExtractBits(a, from+i) & b[i>>6];
+        if (n-i < 64)
+            bits &= (uint64_t(1) << (n-i)) - 1;
+        sum ^= bits;
+    }
+    return Parity(sum);
+}
+
+//-----------------------------------------------------------------------------
+static void TapsBelow(const GF2Words& p, unsigned n, std::vector<unsigned>& taps)
+//-----------------------------------------------------------------------------
+{
+    taps.clear();
+    for (unsigned j=0; j<n; j++) {
+        if (GetBit(p, j))
+            taps.push_back(j);
+    }
+}
+
+//-----------------------------------------------------------------------------
+static void JumpFibonacci(const GF2Words& q, unsigned n, GF2Words& state, const GF2Words& steps)
+//  The sequence a of recurrence polynomial q has a[t+k] = sum r_i a[t+i]
+//  for r = x**k mod q. The state holds a[0] .. a[n-1]; a[n] .. a[2n-2] are
+//  stepped, then a[k] .. a[k+n-1] are n dot products.
+//-----------------------------------------------------------------------------
+{
+    GF2Words r;
+    PolyPowXMod(q, steps, r);
+    r.resize((n+63)/64, 0);
+
+    GF2Words a((2*n+63)/64 + 1, 0);
+    std::copy(state.begin(), state.begin() + (n+63)/64, a.begin());
+    for (unsigned t=n; t<2*n-1; t++) {
+        if (DotBits(a, t-n, q, n))
+            a[t>>6] |= uint64_t(1) << (t&63);
+    }
+    std::fill(state.begin(), state.end(), 0);
+    for (unsigned j=0; j<n; j++) {
+        if (DotBits(a, j, r, n))
+            state[j>>6] |= uint64_t(1) << (j&63);
+    }
+}
+
+//-----------------------------------------------------------------------------
+static void JumpGalois(const GF2Words& p, unsigned n, GF2Words& state, const GF2Words& steps)
+//  a Galois step is a multiplication by 1/x modulo p, which is a shift
+//  right after adding p when the low bit is set. The state is multiplied
+//  by (1/x)**k.
+//-----------------------------------------------------------------------------
+{
+    std::vector<unsigned> taps;
+    TapsBelow(p, n, taps);
+    GF2Modulus mod(n);
+    mod.SetTaps(taps);
+    GF2Words e, pw(p);
+    mod.One(e);
+    pw.resize(mod.Words(), 0);
+    for (unsigned bit=unsigned(steps.size())*64; bit>0; bit--) {
+        mod.Square(e);
+        if (GetBit(steps, bit-1)) {
+            if (e[0] & 1) {
+                for (unsigned i=0; i<e.size(); i++)
+                    e[i] ^= pw[i];
+            }
+            ShiftRightOne(e);
+        }
+    }
+    GF2Words s(state);
+    s.resize(mod.Words(), 0);
+    mod.Mul(e, s);
+    std::copy(e.begin(), e.begin() + state.size(), state.begin());
+}
+
+
+//-----------------------------------------------------------------------------
+LFSRSequence::LFSRSequence()
+//-----------------------------------------------------------------------------
+:   order(0), convention(FIBONACCI), fibMask(0), galoisMask(0), state(0),
+    chunk(0), emit(0), have(0), pending(0), numPending(0)
+{
+}
+
+//-----------------------------------------------------------------------------
+static bool HexToWords(const char* str, GF2Words& w, unsigned shift)
+//  the hex number, shifted up by shift bits
+//-----------------------------------------------------------------------------
+{
+    if (!str)
+        return false;
+    if (str[0]=='0' && (str[1]=='x' || str[1]=='X'))
+        str += 2;
+    const size_t len = strlen(str);
+    if (!len)
+        return false;
+
+    w.assign((4*len+shift)/64 + 1, 0);
+    for (size_t k=0; k<len; k++) {
+        const char c = str[len-1-k];
+        unsigned digit;
+        if (c>='0' && c<='9') digit = c-'0';
+        else if (c>='a' && c<='f') digit = c-'a'+10;
+        else if (c>='A' && c<='F') digit = c-'A'+10;
+        else return false;
+        for (unsigned bit=0; bit<4; bit++) {
+            if ((digit>>bit) & 1) {
+                const size_t e = 4*k+bit+shift;
+                w[e>>6] |= uint64_t(1) << (e&63);
+            }
+        }
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+bool LFSRSequence::ParseHex(const char* str, GF2Words& p)
+//  digit k from the right holds x**(4k+1) .. x**(4k+4)
+//-----------------------------------------------------------------------------
+{
+    if (!HexToWords(str, p, 1))
+        return false;
+    p[0] |= 1;
+    return TopBit(p) > 0;
+}
+
+//-----------------------------------------------------------------------------
+bool LFSRSequence::ParseState(const char* str, GF2Words& state)
+//-----------------------------------------------------------------------------
+{
+    return HexToWords(str, state, 0);
+}
+
+//-----------------------------------------------------------------------------
+bool LFSRSequence::ParseSteps(const char* str, GF2Words& steps)
+//  decimal, or hex with 0x
+//-----------------------------------------------------------------------------
+{
+    if (!str || !*str)
+        return false;
+    if (str[0]=='0' && (str[1]=='x' || str[1]=='X'))
+        return HexToWords(str, steps, 0);
+    steps.assign(1, 0);
+    for (; *str; str++) {
+        if (*str<'0' || *str>'9')
+            return false;
+        // times 10 plus the digit, in halves of words
+        uint64_t carry = uint64_t(*str-'0');
+        for (unsigned i=0; i<steps.size(); i++) {
+            const uint64_t lo = (steps[i] & 0xFFFFFFFFull)*10 + carry;
+            const uint64_t hi = (steps[i] >> 32)*10 + (lo >> 32);
+            steps[i] = (lo & 0xFFFFFFFFull) | (hi << 32);
+            carry = hi >> 32;
+        }
+        if (carry)
+            steps.push_back(carry);
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void LFSRSequence::SubstreamLength(unsigned order, unsigned numStreams, GF2Words& length)
+//  (2**order-1)/numStreams, by long division in halves of words
+//-----------------------------------------------------------------------------
+{
+    length.assign((order+63)/64, ~uint64_t(0));
+    if (order&63)
+        length.back() >>= 64 - (order&63);
+    if (numStreams < 2)
+        return;
+    uint64_t rem = 0;
+    for (unsigned i=unsigned(length.size()); i>0; i--) {
+        const uint64_t hi = (rem << 32) | (length[i-1] >> 32);
+        rem = hi % numStreams;
+        const uint64_t lo = (rem << 32) | (length[i-1] & 0xFFFFFFFFull);
+        rem = lo % numStreams;
+        length[i-1] = ((hi / numStreams) << 32) | (lo / numStreams);
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool LFSRSequence::Init(const GF2Words& p, Convention conv)
+//-----------------------------------------------------------------------------
+{
+    const unsigned n = TopBit(p);
+    if (!n || !GetBit(p, 0))
+        return false;
+    order = n;
+    convention = conv;
+    poly.assign(p.begin(), p.begin() + n/64+1);
+
+    if (order <= 64) {
+        fibMask = poly[0];
+        galoisMask = poly[0] >> 1;
+        if (order == 64) {
+            galoisMask |= uint64_t(1) << 63;
+        } else {
+            fibMask &= (uint64_t(1) << order) - 1;
+        }
+        BuildTables();
+    } else {
+        // the output recurrence a[t+n] = sum of a[t+j] over the taps j
+        taps.clear();
+        for (unsigned j=0; j<order; j++) {
+            if (GetBit(poly, conv==GALOIS ? order-j : j))
+                taps.push_back(j);
+        }
+        recurrence.assign(order/64+1, 0);
+        for (unsigned k=0; k<taps.size(); k++)
+            recurrence[taps[k]>>6] |= uint64_t(1) << (taps[k]&63);
+        recurrence[order>>6] |= uint64_t(1) << (order&63);
+        chunk = order - taps.back();
+        if (chunk > 64)
+            chunk = 64;
+        window.assign(order/64 + WINDOW_EXTRA_WORDS, 0);
+    }
+
+    GF2Words one(1, 1);
+    return SetState(one);
+}
+
+//-----------------------------------------------------------------------------
+bool LFSRSequence::SetState(const GF2Words& s)
+//  for higher orders, the first n output bits are stepped one by one
+//-----------------------------------------------------------------------------
+{
+    if (!order || TopBit(s) >= order)
+        return false;
+    unsigned numWords = (order+63)/64;
+    GF2Words st(s);
+    st.resize(numWords, 0);
+    bool zero = true;
+    for (unsigned i=0; i<numWords; i++)
+        zero = zero && !st[i];
+    if (zero)
+        return false;
+
+    pending = 0;
+    numPending = 0;
+    if (order <= 64) {
+        state = st[0];
+        return true;
+    }
+
+    std::fill(window.begin(), window.end(), 0);
+    emit = 0;
+    have = order;
+    if (convention == FIBONACCI) {
+        std::copy(st.begin(), st.end(), window.begin());
+    } else {
+        GF2Words mask(poly);
+        ShiftRightOne(mask);
+        mask.resize(numWords);
+        for (unsigned t=0; t<order; t++) {
+            const bool out = st[0] & 1;
+            ShiftRightOne(st);
+            if (out) {
+                window[t>>6] |= uint64_t(1) << (t&63);
+                for (unsigned i=0; i<numWords; i++)
+                    st[i] ^= mask[i];
+            }
+        }
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+uint64_t LFSRSequence::StepSmall(uint64_t& s, unsigned numSteps) const
+//  one step at a time, returns the output bits, the first in bit 0
+//-----------------------------------------------------------------------------
+{
+    uint64_t out = 0;
+    for (unsigned t=0; t<numSteps; t++) {
+        const uint64_t bit = s & 1;
+        out |= bit << t;
+        if (convention == FIBONACCI) {
+            const uint64_t fb = Parity(s & fibMask);
+            s = (s >> 1) | (fb << (order-1));
+        } else {
+            s = (s >> 1) ^ (bit ? galoisMask : 0);
+        }
+    }
+    return out;
+}
+
+//-----------------------------------------------------------------------------
+void LFSRSequence::BuildTables(void)
+//  the entry for byte b with value v is the sum of the 64-step results
+//  of the bits in v, built from the entry with the lowest bit cleared
+//-----------------------------------------------------------------------------
+{
+    Step basis[64];
+    for (unsigned j=0; j<64; j++) {
+        basis[j].state = j<order ? uint64_t(1) << j : 0;
+        basis[j].out = j<order ? StepSmall(basis[j].state, 64) : 0;
+    }
+
+    const unsigned numBytes = (order+7)/8;
+    tables.assign(numBytes*256, Step());
+    for (unsigned b=0; b<numBytes; b++) {
+        Step* t = &tables[b*256];
+        t[0].out = t[0].state = 0;
+        for (unsigned v=1; v<256; v++) {
+            unsigned low = 0;
+            while (!((v >> low) & 1))
+                low++;
+            const Step& rest = t[v & (v-1)];
+            t[v].out = rest.out ^ basis[8*b+low].out;
+            t[v].state = rest.state ^ basis[8*b+low].state;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+inline uint64_t LFSRSequence::NextWordSmall(void)
+//-----------------------------------------------------------------------------
+{
+    const unsigned numBytes = (order+7)/8;
+    const Step* t = &tables[0];
+    uint64_t out = 0, next = 0;
+    for (unsigned b=0; b<numBytes; b++, t+=256) {
+        const Step& s = t[(state >> 8*b) & 0xFF];
+        out ^= s.out;
+        next ^= s.state;
+    }
+    state = next;
+    return out;
+}
+
+//-----------------------------------------------------------------------------
+inline uint64_t LFSRSequence::GetBits(uint64_t pos) const
+//  64 bits of the window from pos on
+//-----------------------------------------------------------------------------
+{
+    const uint64_t idx = pos>>6;
+    const unsigned sh = pos&63;
+    uint64_t bits = window[idx] >> sh;
+    if (sh)
+        bits |= window[idx+1] << (64-sh);
+    return bits;
+}
+
+//-----------------------------------------------------------------------------
+void LFSRSequence::Compact(void)
+//  drops the words that are neither returned nor needed by the recurrence
+//-----------------------------------------------------------------------------
+{
+    const uint64_t keep = emit < have-order ? emit : have-order;
+    const size_t drop = size_t(keep>>6);
+    std::copy(window.begin()+drop, window.end(), window.begin());
+    std::fill(window.end()-drop, window.end(), 0);
+    emit -= uint64_t(drop)*64;
+    have -= uint64_t(drop)*64;
+}
+
+//-----------------------------------------------------------------------------
+void LFSRSequence::Generate(unsigned numBits)
+//  steps the recurrence until the window holds numBits bits from emit on
+//-----------------------------------------------------------------------------
+{
+    const uint64_t chunkMask = chunk<64 ? (uint64_t(1) << chunk) - 1 : ~uint64_t(0);
+    while (have < emit+numBits) {
+        if ((have>>6) + 2 >= window.size())
+            Compact();
+        const uint64_t from = have - order;
+        uint64_t bits = 0;
+        for (unsigned k=0; k<taps.size(); k++)
+            bits ^= GetBits(from + taps[k]);
+        XorAtBit(&window[0], unsigned(have), bits & chunkMask);
+        have += chunk;
+    }
+}
+
+//-----------------------------------------------------------------------------
+uint64_t LFSRSequence::NextWordLarge(void)
+//-----------------------------------------------------------------------------
+{
+    Generate(64);
+    const uint64_t w = window[emit>>6];
+    emit += 64;
+    return w;
+}
+
+//-----------------------------------------------------------------------------
+inline uint64_t LFSRSequence::NextWord(void)
+//-----------------------------------------------------------------------------
+{
+    return order <= 64 ? NextWordSmall() : NextWordLarge();
+}
+
+//-----------------------------------------------------------------------------
+void LFSRSequence::Read(uint8_t* buf, uint64_t numBits)
+//  words of 64 bits are stored in little endian byte order, so the output
+//  does not depend on the machine
+//-----------------------------------------------------------------------------
+{
+    if (!order)
+        return;
+    while (numBits >= 64) {
+        const uint64_t w = NextWord();
+        uint64_t bits = w;
+        if (numPending) {
+            bits = pending | (w << numPending);
+            pending = w >> (64-numPending);
+        }
+        for (unsigned i=0; i<8; i++)
+            buf[i] = uint8_t(bits >> 8*i);
+        buf += 8;
+        numBits -= 64;
+    }
+    if (!numBits)
+        return;
+
+    uint64_t bits;
+    if (numPending >= numBits) {
+        bits = pending;
+        pending = numBits<64 ? pending >> numBits : 0;
+        numPending -= unsigned(numBits);
+    } else {
+        const uint64_t w = NextWord();
+        bits = pending | (w << numPending);
+        const uint64_t high = numPending ? w >> (64-numPending) : 0;
+        pending = (bits >> numBits) | (high << (64-numBits));
+        numPending = numPending + 64 - unsigned(numBits);
+    }
+    bits &= (uint64_t(1) << numBits) - 1;
+    for (unsigned i=0; i<(numBits+7)/8; i++)
+        buf[i] = uint8_t(bits >> 8*i);
+}
+
+//-----------------------------------------------------------------------------
+bool LFSRSequence::Advance(GF2Words& s, const GF2Words& steps) const
+//  O(n**2 log k) by x**k (or x**-k) modulo p
+//-----------------------------------------------------------------------------
+{
+    if (!order || TopBit(s) >= order)
+        return false;
+    s.resize((order+63)/64, 0);
+    if (convention == FIBONACCI)
+        JumpFibonacci(poly, order, s, steps);
+    else
+        JumpGalois(poly, order, s, steps);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+bool LFSRSequence::Substreams(const GF2Words& start, unsigned numStreams, std::vector<GF2Words>& states, GF2Words& length) const
+//-----------------------------------------------------------------------------
+{
+    if (!numStreams)
+        return false;
+    SubstreamLength(order, numStreams, length);
+    states.assign(1, start);
+    if (!Advance(states[0], GF2Words()))
+        return false;
+    for (unsigned i=1; i<numStreams; i++) {
+        states.push_back(states.back());
+        Advance(states.back(), length);
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void LFSRSequence::Skip(const GF2Words& steps)
+//  the pending bits are skipped first. Higher orders jump the output
+//  window by the recurrence, whatever the convention.
+//-----------------------------------------------------------------------------
+{
+    if (!order)
+        return;
+    GF2Words rest(steps);
+    if (rest.empty())
+        rest.push_back(0);
+    bool small = rest[0] < numPending;
+    for (unsigned i=1; i<rest.size(); i++)
+        small = small && !rest[i];
+    if (small) {
+        pending >>= rest[0];
+        numPending -= unsigned(rest[0]);
+        return;
+    }
+    // subtract numPending
+    uint64_t borrow = numPending;
+    for (unsigned i=0; i<rest.size() && borrow; i++) {
+        const uint64_t w = rest[i];
+        rest[i] = w - borrow;
+        borrow = w < borrow ? 1 : 0;
+    }
+    pending = 0;
+    numPending = 0;
+
+    if (order <= 64) {
+        GF2Words s(1, state);
+        Advance(s, rest);
+        state = s[0];
+        return;
+    }
+    Generate(order);
+    GF2Words s((order+63)/64, 0);
+    for (unsigned i=0; i<s.size(); i++)
+        s[i] = GetBits(emit + 64*i);
+    if (order&63)
+        s.back() &= (uint64_t(1) << (order&63)) - 1;
+    JumpFibonacci(recurrence, order, s, rest);
+    std::fill(window.begin(), window.end(), 0);
+    std::copy(s.begin(), s.end(), window.begin());
+    emit = 0;
+    have = order;
+}
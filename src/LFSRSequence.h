@@ -0,0 +1,132 @@
+//=============================================================================
+//  Generates the output bit sequence of an LFSR, many steps at a time
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#ifndef LFSRSequence_h
+#define LFSRSequence_h
+#pragma once
+
+#include "GF2Poly.h"
+
+#include <stdint.h>
+#include <vector>
+
+
+//-----------------------------------------------------------------------------
+class LFSRSequence {
+//  The polynomial p(x) of order n has bit i for x**i, including x**0 and
+//  x**n. The output of an ML polynomial is an m-sequence of period 2**n-1.
+//
+//  FIBONACCI: the state holds the next n output bits, the first in bit 0.
+//      Each step outputs bit 0, shifts right and puts the parity of the
+//      state bits at the taps of p below x**n in bit n-1.
+//  GALOIS: each step outputs bit 0 and shifts right; when that bit was
+//      set, the state is xored with the mlpolygen notation of p (bit i
+//      for x**(i+1)). Its output follows the reciprocal of p.
+//
+//  Up to order 64, every 64 steps are taken at once: the state after 64
+//  steps and the 64 bits output on the way are linear in the state, so
+//  they are precomputed (the 64th power of the companion matrix that
+//  LFSRVector::Init builds) for each byte of the state, and a word of
+//  output costs one table lookup per byte. Higher orders step the
+//  output recurrence instead, as many bits at once as the gap between
+//  x**n and the next lower tap allows (up to 64), which is fast for the
+//  sparse polynomials used at such orders.
+//
+//  Jumps ahead by k steps take O(n**2 log k) time: a Fibonacci state is
+//  advanced with x**k mod p, a Galois one is multiplied by x**-k mod p.
+//-----------------------------------------------------------------------------
+  public:
+    enum Convention { FIBONACCI=0, GALOIS=1 };
+
+    LFSRSequence();
+
+    // false unless p has x**0 and an order of 1 or more. The state is 1.
+    bool Init(const GF2Words& p, Convention conv);
+    // false for a zero state or bits at x**n or above
+    bool SetState(const GF2Words& state);
+
+    unsigned Order(void) const { return order; }
+    Convention GetConvention(void) const { return convention; }
+
+    // the next numBits output bits, the first in bit 0 of buf[0].
+    // A partial last byte has its unused high bits cleared.
+    void Read(uint8_t* buf, uint64_t numBits);
+
+    // the state after steps (little endian words of a number) more steps
+    bool Advance(GF2Words& state, const GF2Words& steps) const;
+    // skips the next steps output bits
+    void Skip(const GF2Words& steps);
+
+    // the states at 0, 1, .. numStreams-1 times length steps from start,
+    // length (2**n-1)/numStreams, so they do not overlap for ML polys
+    bool Substreams(const GF2Words& start, unsigned numStreams,
+                    std::vector<GF2Words>& states, GF2Words& length) const;
+    static void SubstreamLength(unsigned order, unsigned numStreams, GF2Words& length);
+
+    // a number of steps, decimal or hex with 0x, as little endian words
+    static bool ParseSteps(const char* str, GF2Words& steps);
+    // mlpolygen notation (with or without 0x) to p as above
+    static bool ParseHex(const char* str, GF2Words& p);
+    // a state in hex, bit i of the number in bit i
+    static bool ParseState(const char* str, GF2Words& state);
+
+  private:
+    struct Step {
+        uint64_t out;
+        uint64_t state;
+    };
+
+    uint64_t NextWord(void);
+    uint64_t NextWordSmall(void);
+    uint64_t NextWordLarge(void);
+    void Generate(unsigned numBits);
+
+    void BuildTables(void);
+    uint64_t StepSmall(uint64_t& state, unsigned numSteps) const;
+    uint64_t GetBits(uint64_t pos) const;
+    void Compact(void);
+
+    unsigned order;
+    Convention convention;
+    GF2Words poly;
+
+    // up to order 64
+    uint64_t fibMask;       // taps of the Fibonacci feedback
+    uint64_t galoisMask;    // mlpolygen notation
+    uint64_t state;
+    std::vector<Step> tables; // 256 entries per byte of the state
+
+    // higher orders: a window of the output sequence, holding the bits
+    // from emit (the next word to return) on, up to have
+    std::vector<unsigned> taps;  // of the output recurrence, below n
+    GF2Words recurrence;         // its polynomial, p or its reciprocal
+    unsigned chunk;              // bits per recurrence step
+    GF2Words window;
+    uint64_t emit;               // next bit to return, a multiple of 64
+    uint64_t have;
+
+    // bits generated but not yet returned by Read()
+    uint64_t pending;
+    unsigned numPending;
+};
+
+#endif
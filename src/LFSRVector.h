@@ -25,6 +25,7 @@
 #pragma once
 
 #include "LFSRPolynomial.h"
+#include "ThreadPool.h"
 #include <vector>
 
 
@@ -40,8 +41,9 @@ class LFSRVector {
 
     void print(std::ostream& os) const;
     
-    void DoFeedback(const LFSRVector& fbvec);
-    void DoMultiShifts(const poly_t& numShifts, const poly_t& poly);
+    // with a pool, the rows of the product are split among its threads
+    void DoFeedback(const LFSRVector& fbvec, ThreadPool* pool=0);
+    void DoMultiShifts(const poly_t& numShifts, const poly_t& poly, ThreadPool* pool=0);
 
     operator const poly_t&(void) const { return vec[0]; }
     poly_t& operator[](unsigned n) { return vec[n]; }
@@ -123,26 +125,35 @@ void LFSRVector<poly_t>::print(std::ostream& os) const
 
 template<typename poly_t>
 //-----------------------------------------------------------------------------
-void LFSRVector<poly_t>::DoFeedback(const LFSRVector& fbvec)
-//  update this vector, feeding back with fbvec
+void LFSRVector<poly_t>::DoFeedback(const LFSRVector& fbvec, ThreadPool* pool)
+//  update this vector, feeding back with fbvec. Each row of the result
+//  only reads fbvec and this, so the rows can be computed in any order.
 //-----------------------------------------------------------------------------
 {
     int order = vec.size();
     LFSRVector<poly_t> result(order);
 
-    for (int i=0; i<order; i++) {
-        for (int j=0; j<order; j++) {
-            if ( fbvec[i][order-1-j] ) {
-                result[i] ^= vec[j];
+    const unsigned numChunks = pool && pool->Size()>1 ? 4*pool->Size() : 1;
+    auto rows = [&](unsigned chunk, unsigned) {
+        const int first = int(chunk*order/numChunks), last = int((chunk+1)*order/numChunks);
+        for (int i=first; i<last; i++) {
+            for (int j=0; j<order; j++) {
+                if ( fbvec[i][order-1-j] ) {
+                    result[i] ^= vec[j];
+                }
             }
         }
-    }
+    };
+    if (numChunks > 1)
+        pool->ParallelFor(numChunks, rows);
+    else
+        rows(0, 0);
     *this = result;
 }
 
 template<typename poly_t>
 //-----------------------------------------------------------------------------
-void LFSRVector<poly_t>::DoMultiShifts(const poly_t& numShifts, const poly_t& poly)
+void LFSRVector<poly_t>::DoMultiShifts(const poly_t& numShifts, const poly_t& poly, ThreadPool* pool)
 //-----------------------------------------------------------------------------
 {
     unsigned order = vec.size();
@@ -157,10 +168,10 @@ void LFSRVector<poly_t>::DoMultiShifts(const poly_t& numShifts, const poly_t& po
     
     for (; i<order; i--) {
         fbvec = *this;
-        DoFeedback(fbvec);
+        DoFeedback(fbvec, pool);
         if (numShifts[i]) {
             fbvec.Init(poly);
-            DoFeedback(fbvec);
+            DoFeedback(fbvec, pool);
         }
     }
 }
@@ -0,0 +1,408 @@
+//=============================================================================
+//  A precomputed index of all ML polynomials of an order, with rank/select
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "MLPolyIndex.h"
+#include "MLPolyTester.h"
+#include "BatchPolyTester.h"
+#include "FactorCache.h"
+#include "RunStats.h"
+#include "ThreadPool.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <iostream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define MLPOLYINDEX_MMAP 1
+#endif
+
+#define INDEX_MAGIC "MLPIDX01"
+#define BLOCK_WORDS 8   // 512 bits per rank entry
+
+
+//-----------------------------------------------------------------------------
+struct MLPolyIndexHeader {
+//  the first 64 bytes of the file, followed by the words and the ranks
+//-----------------------------------------------------------------------------
+    char magic[8];
+    uint32_t order;
+    uint32_t blockWords;
+    uint64_t numPositions;
+    uint64_t numOnes;
+    uint64_t numWords;
+    uint64_t numBlocks;
+    uint64_t reserved[2];
+};
+
+
+//-----------------------------------------------------------------------------
+static inline unsigned PopCount64(uint64_t x)
+//-----------------------------------------------------------------------------
+{
+#if defined(__GNUC__)
+    return __builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ull);
+    x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return unsigned((x * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+//-----------------------------------------------------------------------------
+static inline uint64_t CandidateAt(unsigned order, uint64_t pos)
+//  the low bit makes the number of bits set even
+//-----------------------------------------------------------------------------
+{
+    return (uint64_t(1) << (order-1)) | (pos << 1) | (1 ^ (PopCount64(pos) & 1));
+}
+
+
+//-----------------------------------------------------------------------------
+MLPolyIndex::MLPolyIndex()
+//-----------------------------------------------------------------------------
+:   order(0), numPositions(0), numOnes(0), words(0), ranks(0), numBlocks(0),
+    mapping(0), mappingSize(0)
+{
+}
+
+//-----------------------------------------------------------------------------
+MLPolyIndex::~MLPolyIndex()
+//-----------------------------------------------------------------------------
+{
+    Close();
+}
+
+//-----------------------------------------------------------------------------
+int MLPolyIndex::Build(const char* fileName, unsigned order, unsigned numThreads, RunStats& stats, int verbosity)
+//  tests the candidates in chunks on all threads, a chunk as one block
+//  of BatchPolyTester from its orders on. As with the symmetric pairs
+//  method, polynomials with extra bits in the MSBs are skipped and set
+//  as the duals of the ones found.
+//-----------------------------------------------------------------------------
+{
+    typedef MLPolyTester<default_poly_t,uintmax_t,long double> Tester;
+
+    if (order < 2 || order > MLPOLYINDEX_MAX_ORDER) {
+        std::cerr << "Error: an index can be built for orders 2 to "
+            << MLPOLYINDEX_MAX_ORDER << std::endl;
+        return -1;
+    }
+    const uint64_t numPositions = uint64_t(1) << (order-2);
+    const uint64_t numWords = (numPositions+63)/64;
+    const uint64_t numBlocks = (numWords+BLOCK_WORDS-1)/BLOCK_WORDS;
+    std::vector<uint64_t> words(numWords, 0);
+
+    const std::vector<uintmax_t>& primes = FactorCache<uintmax_t,long double>::Shared().Primes(order);
+    Tester tester(order, primes, verbosity);
+    ThreadPool pool(numThreads);
+    std::vector<Tester> testers(pool.Size(), tester);
+    std::vector<RunStats> threadStats(pool.Size(), RunStats(stats.Timing(), 0, stats.Profiling()));
+    for (unsigned t=0; t<pool.Size(); t++)
+        testers[t].SetStats(&threadStats[t]);
+    stats.SetSpace(order, order-2, tester.ExpectedLog2());
+
+    const bool batched = order >= BATCH_MIN_ORDER;
+    std::vector<BatchPolyTester> batchTesters;
+    if (batched) {
+        BatchPolyTester batchTester(order, std::vector<uint64_t>(primes.begin(), primes.end()));
+        batchTesters.assign(pool.Size(), batchTester);
+        for (unsigned t=0; t<pool.Size(); t++)
+            batchTesters[t].SetStats(&threadStats[t]);
+    }
+    const uint64_t posMask = (uint64_t(1)<<(order-1)) - 1;
+    std::vector< std::vector<uint64_t> > blocks(batched ? pool.Size() : 0);
+
+    const uint64_t chunkSize = numPositions < 4096 ? numPositions : 4096;
+    const uint64_t numChunks = numPositions / chunkSize;
+    const uint64_t roundSize = 64 * pool.Size();
+    std::vector< std::vector<uint64_t> > found;
+
+    for (uint64_t roundStart=0; roundStart<numChunks; roundStart+=roundSize) {
+        const unsigned roundChunks = unsigned(std::min(roundSize, numChunks-roundStart));
+        found.assign(roundChunks, std::vector<uint64_t>());
+
+        pool.ParallelFor(roundChunks, [&](unsigned idx, unsigned thread) {
+            const uint64_t first = (roundStart+idx)*chunkSize;
+            if (batched) {
+                BatchPolyTester& batchTester = batchTesters[thread];
+                std::vector<uint64_t>& block = blocks[thread];
+                block.clear();
+                for (uint64_t pos=first; pos<first+chunkSize; pos++) {
+                    const uint64_t cand = CandidateAt(order, pos);
+                    threadStats[thread].AddCandidates(1);
+                    if (batchTester.IsAsymmetric(cand) == 1)
+                        threadStats[thread].Prefiltered();
+                    else
+                        block.push_back(cand);
+                }
+                unsigned num = unsigned(block.size());
+                const unsigned sieved = batchTester.Sieve(&block[0], num);
+                for (unsigned i=sieved; i<num; i++)
+                    threadStats[thread].Prefiltered();
+                num = batchTester.Squarings(&block[0], sieved);
+                num = batchTester.Factors(&block[0], num);
+                for (unsigned i=0; i<num; i++) {
+                    found[idx].push_back((block[i] & posMask) >> 1);
+                    if (batchTester.IsAsymmetric(block[i]) == -1)
+                        found[idx].push_back((batchTester.Dual(block[i]) & posMask) >> 1);
+                }
+                return;
+            }
+            for (uint64_t pos=first; pos<first+chunkSize; pos++) {
+                LFSRPolynomial<default_poly_t> poly(order, default_poly_t(CandidateAt(order, pos)));
+                threadStats[thread].AddCandidates(1);
+                const int asym = poly.IsAsymmetric();
+                if (asym == 1) {
+                    threadStats[thread].Prefiltered();
+                    continue;
+                }
+                if (testers[thread].TestPolynomial(poly))
+                    continue;
+                found[idx].push_back(pos);
+                if (asym == -1) {
+                    uint64_t dual = ((const default_poly_t&)poly.SymmetricDual()).to_ullong();
+                    found[idx].push_back((dual & posMask) >> 1);
+                }
+            }
+        });
+
+        for (unsigned idx=0; idx<roundChunks; idx++) {
+            for (unsigned i=0; i<found[idx].size(); i++)
+                words[found[idx][i]>>6] |= uint64_t(1) << (found[idx][i]&63);
+        }
+        for (unsigned t=0; t<pool.Size(); t++)
+            stats.Merge(threadStats[t]);
+        if (stats.ProgressDue())
+            stats.Progress(double(roundStart+roundChunks)/numChunks);
+    }
+
+    std::vector<uint32_t> ranks(numBlocks);
+    uint64_t numOnes = 0;
+    for (uint64_t w=0; w<numWords; w++) {
+        if (w % BLOCK_WORDS == 0)
+            ranks[w/BLOCK_WORDS] = uint32_t(numOnes);
+        numOnes += PopCount64(words[w]);
+    }
+    stats.Printed(numOnes);
+
+    MLPolyIndexHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, INDEX_MAGIC, 8);
+    header.order = order;
+    header.blockWords = BLOCK_WORDS;
+    header.numPositions = numPositions;
+    header.numOnes = numOnes;
+    header.numWords = numWords;
+    header.numBlocks = numBlocks;
+
+    FILE* file = fopen(fileName, "wb");
+    if (!file) {
+        std::cerr << "Error opening " << fileName << " for writing" << std::endl;
+        return -1;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1
+        && fwrite(&words[0], sizeof(uint64_t), numWords, file) == numWords
+        && fwrite(&ranks[0], sizeof(uint32_t), numBlocks, file) == numBlocks;
+    ok = (fclose(file) == 0) && ok;
+    if (!ok) {
+        std::cerr << "Error writing " << fileName << std::endl;
+        return -1;
+    }
+    if (1<=verbosity) {
+        std::cerr << "wrote " << fileName << ": " << numOnes
+            << " ML polynomials of order " << order << std::endl;
+    }
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+int MLPolyIndex::Open(const char* fileName, int verbosity)
+//-----------------------------------------------------------------------------
+{
+    Close();
+    FILE* file = fopen(fileName, "rb");
+    if (!file) {
+        if (1<=verbosity)
+            std::cerr << "Note: no index " << fileName << ", testing instead" << std::endl;
+        return -1;
+    }
+    MLPolyIndexHeader header;
+    bool ok = fread(&header, sizeof(header), 1, file) == 1
+        && !memcmp(header.magic, INDEX_MAGIC, 8)
+        && header.order >= 2 && header.order <= MLPOLYINDEX_MAX_ORDER
+        && header.blockWords == BLOCK_WORDS
+        && header.numPositions == uint64_t(1) << (header.order-2)
+        && header.numWords == (header.numPositions+63)/64
+        && header.numBlocks == (header.numWords+BLOCK_WORDS-1)/BLOCK_WORDS;
+    if (!ok) {
+        fclose(file);
+        std::cerr << "Error: " << fileName << " is not an ML polynomial index" << std::endl;
+        return -1;
+    }
+    const size_t size = sizeof(header) + header.numWords*sizeof(uint64_t)
+        + header.numBlocks*sizeof(uint32_t);
+    const char* data = 0;
+
+#ifdef MLPOLYINDEX_MMAP
+    struct stat st;
+    if (fstat(fileno(file), &st) == 0 && size_t(st.st_size) >= size) {
+        void* m = mmap(0, size, PROT_READ, MAP_SHARED, fileno(file), 0);
+        if (m != MAP_FAILED) {
+            mapping = m;
+            mappingSize = size;
+            data = (const char*)m;
+        }
+    }
+#endif
+    if (!data) {
+        buffer.resize((size+7)/8);
+        rewind(file);
+        if (fread(&buffer[0], 1, size, file) == size)
+            data = (const char*)&buffer[0];
+    }
+    fclose(file);
+    if (!data) {
+        std::cerr << "Error reading " << fileName << std::endl;
+        Close();
+        return -1;
+    }
+
+    order = header.order;
+    numPositions = header.numPositions;
+    numOnes = header.numOnes;
+    numBlocks = header.numBlocks;
+    words = (const uint64_t*)(data + sizeof(header));
+    ranks = (const uint32_t*)(data + sizeof(header) + header.numWords*sizeof(uint64_t));
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+void MLPolyIndex::Close(void)
+//-----------------------------------------------------------------------------
+{
+#ifdef MLPOLYINDEX_MMAP
+    if (mapping)
+        munmap(mapping, mappingSize);
+#endif
+    mapping = 0;
+    mappingSize = 0;
+    buffer.clear();
+    words = 0;
+    ranks = 0;
+    order = 0;
+    numPositions = numOnes = numBlocks = 0;
+}
+
+//-----------------------------------------------------------------------------
+uint64_t MLPolyIndex::PolyAt(uint64_t pos) const
+//-----------------------------------------------------------------------------
+{
+    return CandidateAt(order, pos);
+}
+
+//-----------------------------------------------------------------------------
+bool MLPolyIndex::Contains(uint64_t poly) const
+//-----------------------------------------------------------------------------
+{
+    if (!words || (poly >> (order-1)) != 1 || (PopCount64(poly) & 1))
+        return false;
+    const uint64_t pos = (poly & ((uint64_t(1)<<(order-1))-1)) >> 1;
+    return (words[pos>>6] >> (pos&63)) & 1;
+}
+
+//-----------------------------------------------------------------------------
+uint64_t MLPolyIndex::RankPosition(uint64_t pos) const
+//-----------------------------------------------------------------------------
+{
+    if (pos >= numPositions)
+        return numOnes;
+    const uint64_t w = pos>>6;
+    uint64_t rank = ranks[w/BLOCK_WORDS];
+    for (uint64_t i=w-w%BLOCK_WORDS; i<w; i++)
+        rank += PopCount64(words[i]);
+    return rank + PopCount64(words[w] & ((uint64_t(1)<<(pos&63))-1));
+}
+
+//-----------------------------------------------------------------------------
+uint64_t MLPolyIndex::Rank(uint64_t poly) const
+//  the candidate at the position of poly may be below or above it
+//-----------------------------------------------------------------------------
+{
+    if (!words || poly < (uint64_t(1)<<(order-1)))
+        return 0;
+    if (poly >> order)
+        return numOnes;
+    const uint64_t low = poly & ((uint64_t(1)<<(order-1))-1);
+    const uint64_t pos = low >> 1;
+    const uint64_t cand = CandidateAt(order, pos) & ((uint64_t(1)<<(order-1))-1);
+    return RankPosition(cand < low ? pos+1 : pos);
+}
+
+//-----------------------------------------------------------------------------
+bool MLPolyIndex::Select(uint64_t k, uint64_t& poly) const
+//-----------------------------------------------------------------------------
+{
+    if (!words || k >= numOnes)
+        return false;
+    // the last block with fewer than k+1 ones before it
+    uint64_t lo = 0, hi = numBlocks-1;
+    while (lo < hi) {
+        uint64_t mid = (lo+hi+1)/2;
+        if (ranks[mid] <= k) lo = mid;
+        else hi = mid-1;
+    }
+    uint64_t rank = ranks[lo];
+    uint64_t w = lo*BLOCK_WORDS;
+    while (rank + PopCount64(words[w]) <= k)
+        rank += PopCount64(words[w++]);
+    uint64_t bits = words[w];
+    for (; rank<k; rank++)
+        bits &= bits-1; // clear the lowest
+    unsigned bit = 0;
+    while (!((bits >> bit) & 1))
+        bit++;
+    poly = PolyAt(w*64 + bit);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+bool MLPolyIndex::Next(uint64_t poly, uint64_t& next) const
+//-----------------------------------------------------------------------------
+{
+    if (poly >> order)
+        return false;
+    return Select(Rank(poly+1), next);
+}
+
+//-----------------------------------------------------------------------------
+uint64_t MLPolyIndex::CountRange(uint64_t lo, uint64_t hi) const
+//-----------------------------------------------------------------------------
+{
+    if (hi < lo)
+        return 0;
+    return Rank(hi+1) - Rank(lo);
+}
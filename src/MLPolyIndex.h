@@ -0,0 +1,87 @@
+//=============================================================================
+//  A precomputed index of all ML polynomials of an order, with rank/select
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#ifndef MLPolyIndex_h
+#define MLPolyIndex_h
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+class RunStats;
+
+// the index of order 32 is 128 MiB (plus 1/16 for the ranks)
+#define MLPOLYINDEX_MAX_ORDER 32
+
+
+//-----------------------------------------------------------------------------
+class MLPolyIndex {
+//  The candidates of order n have the top bit and an even number of bits
+//  set, so the low bit follows from the others: candidate c has position
+//  (c & (2**(n-1)-1)) >> 1, in the same order. The index file holds a
+//  bitmap over these 2**(n-2) positions, set for the ML polynomials, and
+//  the number of ones before every block of 512 bits, so rank is a table
+//  lookup plus a few popcounts, and select a binary search over blocks.
+//  The file is mapped into memory (or read, where mmap is missing) and is
+//  in native byte order. Polynomials are in the usual hex notation.
+//-----------------------------------------------------------------------------
+  public:
+    MLPolyIndex();
+    ~MLPolyIndex();
+
+    // writes the index for an order from 2 to MLPOLYINDEX_MAX_ORDER
+    static int Build(const char* fileName, unsigned order, unsigned numThreads, RunStats& stats, int verbosity=0);
+
+    int Open(const char* fileName, int verbosity=0);
+    void Close(void);
+    bool IsOpen(void) const { return words != 0; }
+
+    unsigned Order(void) const { return order; }
+    uint64_t Count(void) const { return numOnes; }  // of ML polynomials
+
+    bool Contains(uint64_t poly) const;      // false for other orders
+    uint64_t Rank(uint64_t poly) const;      // number of ML polys below poly
+    bool Select(uint64_t k, uint64_t& poly) const;  // the k-th, from 0
+    bool Next(uint64_t poly, uint64_t& next) const; // the first ML poly > poly
+    uint64_t CountRange(uint64_t lo, uint64_t hi) const; // from lo to hi
+
+  private:
+    MLPolyIndex(const MLPolyIndex&);
+    MLPolyIndex& operator=(const MLPolyIndex&);
+
+    uint64_t RankPosition(uint64_t pos) const; // ones before pos
+    uint64_t PolyAt(uint64_t pos) const;
+
+    unsigned order;
+    uint64_t numPositions;
+    uint64_t numOnes;
+    const uint64_t* words;
+    const uint32_t* ranks;
+    uint64_t numBlocks;
+
+    void* mapping;          // the mmap'd file, or
+    size_t mappingSize;
+    std::vector<uint64_t> buffer; // the file read into memory
+};
+
+#endif
@@ -0,0 +1,1855 @@
+//=============================================================================
+//  The modes of mlpolygen, behind the options of its command line
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "MLPolyModes.h"
+#include "MLPolyTypes.h"
+#include "MLPolyTester.h"
+#include "SparsePolyTester.h"
+#include "BatchPolyTester.h"
+#include "RunStats.h"
+#include "ThreadPool.h"
+#include "SortedPolyWriter.h"
+#include "FactorCache.h"
+#include "PolyServer.h"
+#include "MLPolyIndex.h"
+#include "MLPolyRange.h"
+#include "LFSRSequence.h"
+#include "PolyPeriod.h"
+#include "CosetEnumerator.h"
+#include "PreferredPairs.h"
+#include "SparsestTable.h"
+#include "WorkQueue.h"
+#include "TuneCache.h"
+
+#include <deque>
+#include <stdio.h>
+#include <assert.h>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string.h>
+
+
+template <typename uintT>
+//-----------------------------------------------------------------------------
+int GetUintAsBinaryStr(const char str[], uintT & val, std::string& ostr)
+//  because that's what bitset wants
+//-----------------------------------------------------------------------------
+{
+    std::stringstream ss(str);
+
+    // leading 0x indicates hex, leading 0 indicates oct
+    if (ss.peek() == '0') {
+        char c;
+        ss.get(c);
+        c = ss.peek();
+        if (c == 'x' || c == 'X') {
+            ss.get(c);
+            ss.setf(std::ios::hex, std::ios::basefield);
+        } else {
+            ss.setf(std::ios::oct, std::ios::basefield);
+        }
+    }
+    
+    // get the value
+    bool extracted = !!(ss >> val);
+    if (!extracted)
+        return -1;
+    while (!ss.eof()) {
+        char c;
+        if (ss >> c)
+            return -1; // non-whitespace remained
+    }
+    
+    // now write it to ostr as a binary string 
+    uintT val2 = val;
+    std::deque<char> bdeq;
+    while (val2!=0) {
+        bdeq.push_front( (val2&uintT(1))!=0 ? '1' : '0' );
+        val2 /= 2;
+    }
+    
+    while (bdeq.size()) {
+        ostr += bdeq[0];
+        bdeq.pop_front();
+    }
+    
+    return 0;
+}
+
+// below this, a squaring is too short to split among threads
+#define PARALLEL_TEST_MIN_ORDER 128
+
+template<typename poly_t, typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+int TestSinglePolynomial(const char str[], int verbosity=0, const MLPolyIndex* index=0, unsigned numThreads=1, bool irreducible=false)
+//  looks the polynomial up in the index, if one of its order is open.
+//  From PARALLEL_TEST_MIN_ORDER on, the threads share the one test.
+//  With irreducible, 2**order-1 is not factored, and no index is used.
+//-----------------------------------------------------------------------------
+{
+    std::string bstr;
+    uintT val;
+    int result = GetUintAsBinaryStr<uintT>(str,val,bstr);
+    if (result) {
+        std::cerr << "Error converting to uint" << sizeof(uintT)*8;
+        std::cerr << ": " << str << std::endl;
+        return result;
+    }
+
+    // several -t of the same order factor 2**order-1 only once
+    FactorCache<uintT,fltT>& factorCache = FactorCache<uintT,fltT>::Shared();
+    LFSRPolynomial<poly_t> poly(bstr.c_str());
+    if (!irreducible && index && index->IsOpen() && index->Order()==poly.Order()) {
+        uint64_t bits = 0;
+        for (unsigned bit=0; bit<poly.Order(); bit++)
+            bits |= uint64_t(poly[bit]) << bit;
+        result = index->Contains(bits) ? 0 : -1;
+    } else if (irreducible) {
+        MLPolyTester<poly_t,uintT,fltT> polyTester(poly.Order(),std::vector<uintT>(),verbosity);
+        polyTester.SetIrreducible();
+        ThreadPool pool(poly.Order() >= PARALLEL_TEST_MIN_ORDER ? numThreads : 1);
+        polyTester.SetThreadPool(&pool);
+        result = polyTester.TestPolynomial(poly);
+    } else {
+        MLPolyTester<poly_t,uintT,fltT> polyTester(poly.Order(),factorCache.Primes(poly.Order()),verbosity);
+        ThreadPool pool(poly.Order() >= PARALLEL_TEST_MIN_ORDER ? numThreads : 1);
+        polyTester.SetThreadPool(&pool);
+        result = polyTester.TestPolynomial(poly);
+    }
+
+    std::cout << std::hex << std::setiosflags( std::ios::showbase );
+    std::cout << val << " is ";
+    if (result)
+        std::cout << "NOT ";
+    std::cout << (irreducible ? "irreducible" : "maximal length");
+    std::cout << " for order " << std::dec << poly.Order() << std::endl;
+    std::cout << std::resetiosflags(std::ios::showbase | std::ios::basefield);
+    return result;
+}
+
+template<typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+int PrintPeriod(const GF2Words& poly, int verbosity)
+//  with -v, the factors are listed with their orders
+//-----------------------------------------------------------------------------
+{
+    // the factors of 2**d-1 are shared by all polynomials
+    FactorCache<uintT,fltT>& factorCache = FactorCache<uintT,fltT>::Shared();
+    PolyPeriod<uintT,fltT> period(factorCache);
+    period.Compute(poly);
+
+    const unsigned order = PolyDegree(poly);
+    const uintT maxLen = ((uintT(1) << (order-1)) - uintT(1)) * uintT(2) + uintT(1);
+    std::cout << "0x" << PolyToHex(poly) << " has period " << std::dec << period.Period();
+    if (period.Period() == maxLen)
+        std::cout << " (maximal length)";
+    std::cout << " for order " << order << std::endl;
+    if (1<=verbosity) {
+        const std::vector<GF2Factor>& factors = period.Factors();
+        for (unsigned i=0; i<factors.size(); i++) {
+            std::cout << "  factor 0x" << PolyToHex(factors[i].poly);
+            if (factors[i].multiplicity > 1)
+                std::cout << "^" << factors[i].multiplicity;
+            std::cout << " of degree " << PolyDegree(factors[i].poly)
+                << ", period " << period.FactorOrders()[i] << std::endl;
+        }
+    }
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+int PeriodOfPolynomial(const char str[], int verbosity)
+//-----------------------------------------------------------------------------
+{
+    GF2Words poly;
+    if (!LFSRSequence::ParseHex(str, poly)) {
+        std::cerr << "Error: invalid polynomial: " << str << std::endl;
+        return -1;
+    }
+    if (PolyDegree(poly) <= int(sizeof(reg_poly_t)*8))
+        return PrintPeriod<reg_uint_t,reg_float_t>(poly, verbosity);
+#ifdef USING_GMP
+    return PrintPeriod<big_uint_t,big_float_t>(poly, verbosity);
+#else
+    std::cerr << "Maximum order (without bignum/GMP) is " << sizeof(reg_poly_t)*8 << std::endl;
+    return -1;
+#endif
+}
+
+template<typename poly_t, typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+unsigned FindTwoTapPolynomials(unsigned order, RunStats& stats, int verbosity=0, unsigned sparseTaps=SPARSE_DEFAULT_MAX_TAPS)
+//-----------------------------------------------------------------------------
+{
+    LFSRPolynomial<poly_t> poly(order);
+    SparsePolyTester<poly_t,uintT,fltT> polyTester(poly.Order(),verbosity,sparseTaps);
+    polyTester.SetStats(&stats);
+    stats.SetSpace(order, log2(double(order-1)), -1);
+    unsigned n_results = 0;
+    int result;
+
+    std::cout << std::hex << std::resetiosflags(std::ios::showbase | std::ios::basefield);
+    for (unsigned k = 0; k < order -1; ++k)
+    {
+        poly.Clear();
+        poly.set(order -1, 1);
+        poly.set(k, 1);
+        if (stats.Enumerated())
+            stats.Progress(double(k)/(order-1));
+        stats.Lap(RunStats::ENUMERATE);
+
+        result = polyTester.TestPolynomial(poly);
+        if (result)
+            continue;
+        ++n_results;
+        stats.Printed();
+        std::cout << std::dec << n_results << ": 0x" << poly;
+        if (verbosity >= 1) {
+            const unsigned n_taps_set = poly.NumBitsSet();
+            std::cout << "\t# " << std::dec << n_taps_set;
+            if (verbosity >= 2)
+                std::cout << ": 0," << k+1 << "," << order;
+        }
+        std::cout << std::endl;
+        stats.Lap(RunStats::OUTPUT);
+    }
+    std::cout << std::dec;
+    return n_results;
+}
+
+//-----------------------------------------------------------------------------
+std::string TapsToHex(unsigned order, const unsigned* taps, unsigned numTaps)
+//  the polynomial with x**order and x**taps[i] (each 0<tap<order) in the
+//  notation of mlpolygen, bit i for x**(i+1), the hex digits from the top
+//-----------------------------------------------------------------------------
+{
+    static const char digits[] = "0123456789abcdef";
+    std::vector<unsigned> nibbles((order+3)/4, 0);
+    nibbles[nibbles.size()-1-(order-1)/4] |= 1u << ((order-1)%4);
+    for (unsigned i=0; i<numTaps; i++)
+        nibbles[nibbles.size()-1-(taps[i]-1)/4] |= 1u << ((taps[i]-1)%4);
+    std::string hex;
+    for (unsigned i=0; i<nibbles.size(); i++)
+        hex += digits[nibbles[i]];
+    return hex;
+}
+
+//-----------------------------------------------------------------------------
+unsigned FindMersenneTrinomials(unsigned order, unsigned numThreads, RunStats& stats, int verbosity=0)
+//  -2 for an order with 2**order-1 prime: every irreducible polynomial is
+//  ML then, and as the order is prime too, x**(2**order) = x mod p is the
+//  whole test, without 2**order-1 to factor. Swan's theorem rules out
+//  most taps k first, and each k left is tested together with order-k, the
+//  reciprocal, by sparse squaring on the threads, a modulus for each.
+//-----------------------------------------------------------------------------
+{
+    std::vector<unsigned> candidates;
+    for (unsigned k=1; k<=order/2; k++) {
+        if (!TrinomialHasEvenFactors(order, k))
+            candidates.push_back(k);
+        else
+            stats.Prefiltered();
+    }
+    stats.SetSpace(order, log2(double(order-1)), -1);
+    if (1<=verbosity) {
+        std::cerr << "order " << std::dec << order << " is a Mersenne exponent, " << candidates.size()
+            << " of " << order/2 << " trinomials are left by Swan's theorem" << std::endl;
+    }
+
+    ThreadPool pool(numThreads);
+    std::vector<GF2Modulus> moduli(pool.Size(), GF2Modulus(order));
+    std::vector<char> isML(candidates.size(), 0);
+    pool.ParallelFor(unsigned(candidates.size()), [&](unsigned i, unsigned thread) {
+        GF2Modulus& modulus = moduli[thread];
+        std::vector<unsigned> taps(2, 0);
+        taps[1] = candidates[i];
+        modulus.SetTaps(taps);
+        GF2Words xPow, xVal;
+        modulus.X(xPow);
+        modulus.X(xVal);
+        for (unsigned s=0; s<order; s++)
+            modulus.Square(xPow);
+        isML[i] = xPow == xVal;
+    });
+    for (unsigned i=0; i<candidates.size(); i++) {
+        stats.Enumerated();
+        stats.Tested(isML[i] ? 0 : -2);
+    }
+    stats.Lap(RunStats::SQUARING);
+
+    // exponents of the middle tap, in the order of FindTwoTapPolynomials()
+    std::vector<unsigned> found;
+    for (unsigned i=0; i<candidates.size(); i++) {
+        if (!isML[i])
+            continue;
+        found.push_back(candidates[i]);
+        if (2*candidates[i] != order)
+            found.push_back(order-candidates[i]);
+    }
+    std::sort(found.begin(), found.end());
+    for (unsigned i=0; i<found.size(); i++) {
+        stats.Printed();
+        std::cout << std::dec << i+1 << ": 0x" << TapsToHex(order, &found[i], 1);
+        if (verbosity >= 1) {
+            std::cout << "\t# " << std::dec << 2;
+            if (verbosity >= 2)
+                std::cout << ": 0," << found[i] << "," << order;
+        }
+        std::cout << std::endl;
+    }
+    stats.Lap(RunStats::OUTPUT);
+    return unsigned(found.size());
+}
+
+// each measurement of --tune repeats its tests for this long
+#define TUNE_MIN_SECONDS 0.05
+
+// the random candidates of a measurement
+#define TUNE_NUM_CANDIDATES 16
+
+// the block sizes of BatchPolyTester that --tune tries, by factors of 4
+#define TUNE_MIN_BLOCK_SIZE 256
+#define TUNE_MAX_BLOCK_SIZE 65536
+
+//-----------------------------------------------------------------------------
+unsigned TuneBlockSize(unsigned order, int verbosity=0)
+//  the block size of the least time per candidate, through all stages of
+//  BatchPolyTester, on the candidates from 2**(order-1) on as searched.
+//  They wrap around below 2**order, as small orders have fewer than the
+//  largest block.
+//-----------------------------------------------------------------------------
+{
+    typedef std::chrono::steady_clock clock;
+    FactorCache<reg_uint_t,reg_float_t>& factorCache = FactorCache<reg_uint_t,reg_float_t>::Shared();
+    const std::vector<reg_uint_t>& primes = factorCache.Primes(order);
+    BatchPolyTester polyTester(order, std::vector<uint64_t>(primes.begin(), primes.end()));
+
+    const uint64_t first = uint64_t(1) << (order-1);
+    const uint64_t last = first | (first-1);
+    unsigned bestSize = 0;
+    double bestTime = 0;
+    for (unsigned size=TUNE_MIN_BLOCK_SIZE; size<=TUNE_MAX_BLOCK_SIZE; size*=4) {
+        std::vector<uint64_t> block(size);
+        uint64_t next = first;
+        unsigned long numCands = 0;
+        double seconds = 0;
+        const clock::time_point t0 = clock::now();
+        do {
+            unsigned num = 0;
+            for (; num<size; next = next==last ? first : next+1) {
+                if (!(PolyPopCount(next) & 1))
+                    block[num++] = next;
+            }
+            num = polyTester.Sieve(&block[0], num);
+            num = polyTester.Squarings(&block[0], num);
+            polyTester.Factors(&block[0], num);
+            numCands += size;
+            seconds = std::chrono::duration<double>(clock::now() - t0).count();
+        } while (seconds < TUNE_MIN_SECONDS);
+        const double time = seconds / numCands;
+        if (1<=verbosity)
+            std::cerr << "order " << order << ": blocks of " << size << ", " << time*1e6 << " us per candidate" << std::endl;
+        if (!bestSize || time < bestTime) {
+            bestSize = size;
+            bestTime = time;
+        }
+    }
+    return bestSize;
+}
+
+template<typename poly_t, typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+double TuneSecondsPerTest(SparsePolyTester<poly_t,uintT,fltT>& polyTester, const std::vector<poly_t>& polys, bool sparse)
+//  the mean time of a test of polys, repeated for TUNE_MIN_SECONDS
+//-----------------------------------------------------------------------------
+{
+    typedef std::chrono::steady_clock clock;
+    const clock::time_point t0 = clock::now();
+    unsigned long numTests = 0;
+    double seconds = 0;
+    do {
+        for (unsigned i=0; i<polys.size(); i++) {
+            if (sparse)
+                polyTester.TestSparse(polys[i]);
+            else
+                polyTester.MLPolyTester<poly_t,uintT,fltT>::TestPolynomial(polys[i]);
+        }
+        numTests += polys.size();
+        seconds = std::chrono::duration<double>(clock::now() - t0).count();
+    } while (seconds < TUNE_MIN_SECONDS);
+    return seconds / numTests;
+}
+
+template<typename poly_t, typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+void TuneCandidates(unsigned order, unsigned taps, std::minstd_rand& lcg, std::vector<poly_t>& polys)
+//  random candidates with the top bit and taps-1 others set
+//-----------------------------------------------------------------------------
+{
+    std::vector<unsigned> bits(order-1);
+    for (unsigned i=0; i<bits.size(); i++)
+        bits[i] = i;
+    for (unsigned p=0; p<polys.size(); p++) {
+        polys[p] = poly_t(0);
+        polys[p].set(order-1);
+        for (unsigned i=0; i+1<taps; i++) {
+            std::swap(bits[i], bits[i + lcg() % (bits.size()-i)]);
+            polys[p].set(bits[i]);
+        }
+    }
+}
+
+template<typename poly_t, typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+TuneSettings TuneOrder(unsigned order, int verbosity=0)
+//  The matrix method costs the same for any candidate, sparse reduction
+//  grows with its taps: the largest even number of taps for which it is
+//  still faster is the one for --sparse-taps, all of them if it always is.
+//  The step grows with the taps, as the cost is about linear in them.
+//  For the orders of BatchPolyTester, its block size is tuned as well.
+//-----------------------------------------------------------------------------
+{
+    SparsePolyTester<poly_t,uintT,fltT> polyTester(order, 0, order);
+    std::minstd_rand lcg(order);
+    std::vector<poly_t> polys(TUNE_NUM_CANDIDATES);
+
+    TuneCandidates<poly_t,uintT,fltT>(order, (order/2) & ~1u, lcg, polys);
+    const double matrixTime = TuneSecondsPerTest(polyTester, polys, false);
+    if (1<=verbosity)
+        std::cerr << "order " << order << ": matrix " << matrixTime*1e6 << " us per test" << std::endl;
+
+    TuneSettings settings = { order, 0 };
+    unsigned faster = 0;
+    for (unsigned taps=2; taps<=order; taps += taps < 16 ? 2 : (taps/8) & ~1u) {
+        TuneCandidates<poly_t,uintT,fltT>(order, taps, lcg, polys);
+        const double sparseTime = TuneSecondsPerTest(polyTester, polys, true);
+        if (1<=verbosity)
+            std::cerr << "order " << order << ": sparse " << sparseTime*1e6 << " us per test with " << taps << " taps" << std::endl;
+        if (sparseTime >= matrixTime) {
+            settings.sparseTaps = faster;
+            break;
+        }
+        faster = taps;
+    }
+    if (BATCH_MIN_ORDER <= order && order <= BATCH_MAX_ORDER)
+        settings.blockSize = TuneBlockSize(order, verbosity);
+    return settings;
+}
+
+//-----------------------------------------------------------------------------
+int TuneAndStore(unsigned order, bool bignum, int verbosity=0)
+//  TuneOrder() with the types of the search, the settings go to the cache
+//-----------------------------------------------------------------------------
+{
+    if (order < 3) {
+        std::cerr << "Error: --tune needs an order from 3" << std::endl;
+        return -1;
+    }
+    TuneCache cache;
+    cache.Load();
+    TuneSettings settings;
+    if (!bignum)
+        settings = TuneOrder<reg_poly_t,reg_uint_t,reg_float_t>(order, verbosity);
+#ifdef USING_GMP
+    else
+        settings = TuneOrder<big_poly_t,big_uint_t,big_float_t>(order, verbosity);
+#endif
+    cache.Store(order, settings);
+    if (cache.Save())
+        return -1;
+    std::cout << "order " << order << ": sparse-taps " << settings.sparseTaps;
+    if (settings.blockSize)
+        std::cout << ", block-size " << settings.blockSize;
+    std::cout << " (" << cache.Model() << ", " << TuneCache::FileName() << ")" << std::endl;
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+int ParseTapList(const char* str, std::vector<unsigned>& taps)
+//  comma separated tap exponents or ranges of them, e.g. "1,4,7-12"
+//-----------------------------------------------------------------------------
+{
+    std::stringstream ss(str);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        unsigned first, last;
+        char dash;
+        std::stringstream is(item);
+        if (!(is >> first))
+            return -1;
+        last = first;
+        if (is >> dash) {
+            if (dash != '-' || !(is >> last) || last < first)
+                return -1;
+        }
+        for (unsigned tap=first; tap<=last; tap++)
+            taps.push_back(tap);
+    }
+    std::sort(taps.begin(), taps.end());
+    taps.erase(std::unique(taps.begin(), taps.end()), taps.end());
+    return taps.empty() ? -1 : 0;
+}
+
+//-----------------------------------------------------------------------------
+int TapWindow(int shiftUp, int bruteForceNumBits, unsigned order, std::vector<unsigned>& taps)
+//  the taps of options -u and -f, as exponents shiftUp+1 .. shiftUp+bits
+//-----------------------------------------------------------------------------
+{
+    if (shiftUp < 0) {
+        std::cerr << "shiftUp = " << shiftUp
+            << ": only values >= 0 supported!" << std::endl;
+        return -1;
+    }
+    if (bruteForceNumBits <= 0) {
+        std::cerr << "bruteForceNumBits = " << bruteForceNumBits
+            << ": only values > 0 supported!" << std::endl;
+        return -1;
+    }
+    if (unsigned(shiftUp+bruteForceNumBits) >= order) {
+        std::cerr << "shiftUp + bruteForceNumBits = " << shiftUp + bruteForceNumBits
+            << ": only values < 'order' supported!" << std::endl;
+        return -1;
+    }
+    for (int k = 0; k < bruteForceNumBits; ++k)
+        taps.push_back(shiftUp + k + 1);
+    return 0;
+}
+
+template<typename poly_t, typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+unsigned BruteForceFindPolynomials(const std::vector<unsigned>& tapList, unsigned order, unsigned long numPolys, unsigned numThreads, RunStats& stats, int verbosity=0, unsigned sparseTaps=SPARSE_DEFAULT_MAX_TAPS, int maximum_taps=-1, int exact_taps=-1)
+//  tests all polynomials made of the top tap and any subset of tapList.
+//  Subsets are numbered by a bit mask and processed in chunks by the
+//  threads. Chunks are printed in order as soon as all earlier ones are
+//  done, so the output does not depend on the number of threads, and
+//  with numPolys the chunks after the last needed one are abandoned.
+//-----------------------------------------------------------------------------
+{
+    const unsigned numBits = tapList.size();
+    if (numBits == 0 || numBits > 63) {
+        std::cerr << "number of taps to search = " << numBits
+            << ": only values 1 .. 63 supported!" << std::endl;
+        return 0;
+    }
+    for (unsigned k = 0; k < numBits; ++k) {
+        if (tapList[k] < 1 || tapList[k] >= order) {
+            std::cerr << "tap = " << tapList[k]
+                << ": only values 1 .. 'order'-1 supported!" << std::endl;
+            return 0;
+        }
+    }
+
+    LFSRPolynomial<poly_t> poly(order);
+    SparsePolyTester<poly_t,uintT,fltT> polyTester(poly.Order(),verbosity,sparseTaps);
+    stats.SetSpace(order, numBits, -1);
+
+    // per thread copies of the tester and counters
+    ThreadPool pool(numThreads);
+    std::vector< SparsePolyTester<poly_t,uintT,fltT> > testers(pool.Size(), polyTester);
+    std::vector<RunStats> threadStats(pool.Size(), RunStats(stats.Timing(), 0, stats.Profiling()));
+    for (unsigned t = 0; t < pool.Size(); ++t)
+        testers[t].SetStats(&threadStats[t]);
+
+    const uint64_t numCombs = (uint64_t(1) << numBits) - 1; // 1 .. numCombs
+    const uint64_t chunkSize = 1024;
+    const uint64_t numChunks = (numCombs + chunkSize - 1) / chunkSize;
+    const uint64_t roundSize = 1 << 16;
+
+    std::mutex mutex;
+    std::atomic<uint64_t> stopChunk(numChunks);
+    std::vector< std::vector<std::string> > chunkResults;
+    std::vector<bool> chunkDone;
+    uint64_t nextChunk = 0; // the next one to print
+    unsigned n_results = 0;
+
+    for (uint64_t roundStart = 0; roundStart < numChunks && roundStart < stopChunk; roundStart += roundSize) {
+        const uint64_t roundChunks = std::min(roundSize, numChunks - roundStart);
+        chunkResults.assign(roundChunks, std::vector<std::string>());
+        chunkDone.assign(roundChunks, false);
+
+        pool.ParallelFor(unsigned(roundChunks), [&](unsigned idx, unsigned thread) {
+            const uint64_t chunk = roundStart + idx;
+            SparsePolyTester<poly_t,uintT,fltT>& tester = testers[thread];
+            RunStats& tstats = threadStats[thread];
+            LFSRPolynomial<poly_t> poly(order);
+            std::vector<std::string>& results = chunkResults[idx];
+            const uint64_t lastComb = std::min(chunk*chunkSize + chunkSize, numCombs);
+
+            for (uint64_t comb = chunk*chunkSize + 1; comb <= lastComb; ++comb) {
+                if (chunk > stopChunk.load(std::memory_order_relaxed))
+                    break;
+                tstats.AddCandidates(1);
+                // with the top tap, an even number of taps is needed
+                const int n_taps_set = int(std::bitset<64>(comb).count()) + 1;
+                if ((n_taps_set & 1) || (maximum_taps != -1 && n_taps_set > maximum_taps)
+                        || (exact_taps != -1 && n_taps_set != exact_taps)) {
+                    tstats.Prefiltered();
+                    continue;
+                }
+                poly.Clear();
+                poly.set(order -1, 1);
+                for (unsigned k = 0; k < numBits; ++k) {
+                    if ( (comb >> k) & 1 )
+                        poly.set(tapList[k] - 1, 1);
+                }
+                tstats.Lap(RunStats::ENUMERATE);
+
+                if (tester.TestPolynomial(poly))
+                    continue;
+                std::ostringstream os;
+                os << "0x" << std::hex << poly;
+                if (verbosity >= 1) {
+                    os << "\t# " << std::dec << n_taps_set << ": 0";
+                    for (unsigned k = 0; k < order; ++k) {
+                        if (poly[k])
+                            os << "," << k+1;
+                    }
+                }
+                results.push_back(os.str());
+                tstats.Lap(RunStats::OUTPUT);
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            stats.Merge(tstats);
+            chunkDone[idx] = true;
+            while (nextChunk < roundStart + roundChunks && chunkDone[nextChunk - roundStart]
+                    && nextChunk <= stopChunk) {
+                const std::vector<std::string>& lines = chunkResults[nextChunk - roundStart];
+                for (unsigned r = 0; r < lines.size() && !(numPolys && n_results >= numPolys); ++r) {
+                    ++n_results;
+                    std::cout << std::dec << n_results << ": " << lines[r] << "\n";
+                    stats.Printed();
+                }
+                if (numPolys && n_results >= numPolys)
+                    stopChunk = nextChunk;
+                ++nextChunk;
+            }
+            if (stats.ProgressDue())
+                stats.Progress(double(nextChunk)/numChunks);
+        });
+    }
+    std::cout.flush();
+    return n_results;
+}
+
+
+template<typename poly_t, typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+int GenerateRandomPolys(unsigned long order, unsigned long numRands, RunStats& stats, int verbosity=0, bool irreducible=false)
+//-----------------------------------------------------------------------------
+{
+    MLPolyTester<poly_t,uintT,fltT> polyTester = irreducible
+        ? MLPolyTester<poly_t,uintT,fltT>(order,std::vector<uintT>(),verbosity)
+        : MLPolyTester<poly_t,uintT,fltT>(order,verbosity);
+    if (irreducible)
+        polyTester.SetIrreducible();
+    polyTester.SetStats(&stats);
+    stats.SetSpace(order, order>1 ? order-2 : 0, polyTester.ExpectedLog2());
+    while (numRands) {
+        LFSRPolynomial<poly_t> poly(order);
+        poly.SetRandom();
+        if (1<=verbosity) {
+            std::cerr << "Random poly: " << poly << std::endl;
+        }
+        while (1) {
+            if (stats.Enumerated())
+                stats.Progress(-1);
+            stats.Lap(RunStats::ENUMERATE);
+            int result = polyTester.TestPolynomial(poly);
+            if (!result) {
+                std::cout << poly << std::endl;
+                stats.Printed();
+                stats.Lap(RunStats::OUTPUT);
+                numRands--;
+                break;
+            }
+            poly.next_candidate();
+            if (poly.end_candidate()) {
+                poly = LFSRPolynomial<poly_t>(order);
+            }
+            if (2<=verbosity) {
+                std::cerr << "Next poly: " << poly << std::endl;
+            }
+        }
+    }
+    return 0;
+}
+
+template<typename poly_t>
+//-----------------------------------------------------------------------------
+double RangeLog2(const LFSRPolynomial<poly_t>& lo, const LFSRPolynomial<poly_t>& hi)
+//  log2 of the number of values from lo to hi
+//-----------------------------------------------------------------------------
+{
+    int top = hi.Order()-1;
+    while (top>=0 && lo[top]==hi[top])
+        top--;
+    if (top<0)
+        return 0;
+    double dl = 0, dh = 0;
+    int bit = top;
+    for (; bit>=0 && bit>top-53; bit--) {
+        dl = 2*dl + lo[bit];
+        dh = 2*dh + hi[bit];
+    }
+    return log2(dh-dl+1) + (bit+1);
+}
+
+template<typename poly_t>
+//-----------------------------------------------------------------------------
+double RangeFraction(const LFSRPolynomial<poly_t>& v, const LFSRPolynomial<poly_t>& lo, const LFSRPolynomial<poly_t>& hi)
+//  how far v has progressed from lo to hi, looking at the 53 bits below
+//  the highest bit where lo and hi differ
+//-----------------------------------------------------------------------------
+{
+    int top = hi.Order()-1;
+    while (top>=0 && lo[top]==hi[top])
+        top--;
+    if (top<0)
+        return 1;
+    double dv = 0, dl = 0, dh = 0;
+    for (int bit=top; bit>=0 && bit>top-53; bit--) {
+        dv = 2*dv + v[bit];
+        dl = 2*dl + lo[bit];
+        dh = 2*dh + hi[bit];
+    }
+    return (dv-dl)/(dh-dl);
+}
+
+//-----------------------------------------------------------------------------
+int QueryPolynomials(const MLPolyIndex& index, unsigned long order, unsigned long kth, const char* nextAfter, bool countRange, const char* startVal, const char* endVal)
+//  the k-th ML polynomial (from 1), the next one after a polynomial, or
+//  the number of them from start to end. They come from the index if it
+//  is for this order, else from testing the candidates.
+//-----------------------------------------------------------------------------
+{
+    uint64_t next = 0, start = 0, end = 0;
+    const char* vals[3] = { nextAfter, startVal, endVal };
+    uint64_t* dest[3] = { &next, &start, &end };
+    for (unsigned v=0; v<3; v++) {
+        if (!vals[v])
+            continue;
+        std::string bstr;
+        reg_uint_t val;
+        if (GetUintAsBinaryStr<reg_uint_t>(vals[v],val,bstr) || bstr.empty()) {
+            std::cerr << "Error converting to uint" << sizeof(reg_uint_t)*8;
+            std::cerr << ": " << vals[v] << std::endl;
+            return -1;
+        }
+        *dest[v] = val;
+        if (!order)
+            order = bstr.size();
+    }
+    if (!order || order > sizeof(reg_poly_t)*8) {
+        std::cerr << "Error: queries are supported for orders 1 to " << sizeof(reg_poly_t)*8 << std::endl;
+        return -1;
+    }
+    const uint64_t top = uint64_t(1) << (order-1);
+    const uint64_t last = top | (top-1);
+    if (!startVal) start = top;
+    if (!endVal) end = last;
+
+    const bool indexed = index.IsOpen() && index.Order()==order;
+    MLPolyRange<reg_poly_t,reg_uint_t,reg_float_t> range(order);
+
+    if (countRange) {
+        uint64_t count = 0;
+        if (indexed) {
+            count = index.CountRange(start, end);
+        } else if (start <= end && start <= last && end >= top) {
+            range.SetStart(LFSRPolynomial<reg_poly_t>(order, reg_poly_t(std::max(start, top))));
+            range.SetEnd(LFSRPolynomial<reg_poly_t>(order, reg_poly_t(std::min(end, last))));
+            for (MLPolyRange<reg_poly_t,reg_uint_t,reg_float_t>::iterator it=range.begin(); it!=range.end(); ++it)
+                count++;
+        }
+        std::cout << std::dec << count << std::endl;
+        return 0;
+    }
+
+    bool found = false;
+    uint64_t poly = 0;
+    if (indexed) {
+        found = nextAfter ? index.Next(next, poly) : kth && index.Select(kth-1, poly);
+    } else if (!nextAfter || next < last) {
+        if (nextAfter && next >= top)
+            range.SetStart(LFSRPolynomial<reg_poly_t>(order, reg_poly_t(next+1)));
+        MLPolyRange<reg_poly_t,reg_uint_t,reg_float_t>::iterator it = range.begin();
+        for (unsigned long k=1; it!=range.end() && !nextAfter && k<kth; k++)
+            ++it;
+        if (it!=range.end() && (nextAfter || kth)) {
+            poly = ((const reg_poly_t&)*it).to_ullong();
+            found = true;
+        }
+    }
+    if (!found) {
+        std::cerr << "no such ML polynomial of order " << std::dec << order << std::endl;
+        return -1;
+    }
+    std::cout << LFSRPolynomial<reg_poly_t>(order, reg_poly_t(poly)) << std::endl;
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+int EmitSequence(const char* polyStr, const char* seedStr, bool galois, uint64_t numBits, const char* skipStr, const char* substreamStr, int verbosity)
+//  numBits 0 writes until stdout is closed
+//-----------------------------------------------------------------------------
+{
+    GF2Words poly, seed(1, 1);
+    LFSRSequence seq;
+    if (!LFSRSequence::ParseHex(polyStr, poly) ||
+        !seq.Init(poly, galois ? LFSRSequence::GALOIS : LFSRSequence::FIBONACCI)) {
+        std::cerr << "Error: invalid polynomial: " << polyStr << std::endl;
+        return -1;
+    }
+    if (seedStr && (!LFSRSequence::ParseState(seedStr, seed) || !seq.SetState(seed))) {
+        std::cerr << "Error: the seed must be nonzero and below x**" << seq.Order() << ": " << seedStr << std::endl;
+        return -1;
+    }
+    GF2Words steps;
+    if (skipStr) {
+        if (!LFSRSequence::ParseSteps(skipStr, steps)) {
+            std::cerr << "Error converting to a number of steps: " << skipStr << std::endl;
+            return -1;
+        }
+        seq.Skip(steps);
+    }
+    if (substreamStr) {
+        unsigned index = 0, count = 0;
+        char slash = 0;
+        std::istringstream is(substreamStr);
+        if (!(is >> index >> slash >> count) || slash!='/' || index>=count || !is.eof()) {
+            std::cerr << "Error: expected i/N with i < N: " << substreamStr << std::endl;
+            return -1;
+        }
+        LFSRSequence::SubstreamLength(seq.Order(), count, steps);
+        for (unsigned i=0; i<index; i++)
+            seq.Skip(steps);
+        if (!numBits && steps.size()==1)
+            numBits = steps[0];
+    }
+    if (1<=verbosity)
+        std::cerr << "emitting the " << (galois ? "Galois" : "Fibonacci") << " sequence of order " << seq.Order() << std::endl;
+
+    const uint64_t bufferBits = uint64_t(1) << 23;
+    std::vector<uint8_t> buffer(bufferBits/8);
+    for (uint64_t done=0; !numBits || done<numBits; ) {
+        const uint64_t bits = numBits && numBits-done < bufferBits ? numBits-done : bufferBits;
+        seq.Read(&buffer[0], bits);
+        const size_t bytes = size_t((bits+7)/8);
+        if (fwrite(&buffer[0], 1, bytes, stdout) != bytes) {
+            if (numBits) {
+                std::cerr << "Error writing the sequence" << std::endl;
+                return -1;
+            }
+            break;
+        }
+        done += bits;
+    }
+    return fflush(stdout) && numBits ? -1 : 0;
+}
+
+//-----------------------------------------------------------------------------
+int EnumerateCosets(unsigned long order, unsigned long numPolys, bool inPairs, bool sorted, size_t sortMemory, unsigned numThreads, RunStats& stats, int verbosity)
+//  all ML polynomials from the first one, sorted unless in pairs. In
+//  pairs, only the smaller coset of k and -k is computed, and the
+//  polynomial is printed with its dual. The order of the polynomials is
+//  not that of the cosets, so with numPolys, sorted output is of those
+//  of the first cosets, which are all that is computed.
+//-----------------------------------------------------------------------------
+{
+    if (order < 2 || order > sizeof(reg_poly_t)*8) {
+        std::cerr << "Error: --cosets is supported for orders 2 to " << sizeof(reg_poly_t)*8 << std::endl;
+        return -1;
+    }
+    FactorCache<reg_uint_t,reg_float_t>& factorCache = FactorCache<reg_uint_t,reg_float_t>::Shared();
+    MLPolyRange<reg_poly_t,reg_uint_t,reg_float_t> range(order, &factorCache);
+    const reg_poly_t seed = *range.begin();
+    const std::vector<reg_uint_t>& factors = factorCache.Primes(order);
+
+    CosetEnumerator cosets;
+    cosets.Init(order, seed.to_ullong(), std::vector<uint64_t>(factors.begin(), factors.end()));
+    if (1<=verbosity)
+        std::cerr << "cosets of order " << std::dec << order << " from " << LFSRPolynomial<reg_poly_t>(order, seed) << std::endl;
+
+    SortedPolyWriter<reg_poly_t> pending(order, std::cout, sortMemory);
+    sorted = sorted || !inPairs;
+    const uint64_t mask = order < 64 ? (uint64_t(1) << order) - 1 : ~uint64_t(0);
+
+    ThreadPool pool(numThreads);
+    const unsigned batchSize = 4096;
+    std::vector<uint64_t> leaders;
+    std::vector<uint64_t> polys(batchSize);
+    std::vector<char> paired(batchSize);
+    unsigned long polysFound = 0;
+    while ((!numPolys || polysFound<numPolys) && cosets.NextLeaders(leaders, batchSize)) {
+        pool.ParallelFor(unsigned(leaders.size()), [&](unsigned i, unsigned) {
+            const uint64_t dual = cosets.Leader(mask ^ leaders[i]);
+            polys[i] = inPairs && dual < leaders[i] ? 0 : cosets.Polynomial(leaders[i]);
+            paired[i] = inPairs && dual != leaders[i];
+        });
+        stats.Lap(RunStats::ENUMERATE);
+        for (unsigned i=0; i<leaders.size(); i++) {
+            if (!polys[i])
+                continue;
+            LFSRPolynomial<reg_poly_t> poly(order, reg_poly_t(polys[i]));
+            for (int twice=paired[i]; twice>=0 && (!numPolys || polysFound<numPolys); twice--) {
+                if (sorted) {
+                    pending.Defer(poly);
+                } else {
+                    std::cout << poly << std::endl;
+                    stats.Printed();
+                }
+                polysFound++;
+                poly = poly.SymmetricDual();
+            }
+        }
+        stats.Lap(RunStats::OUTPUT);
+    }
+    if (sorted) {
+        unsigned long released = pending.Release(0, numPolys ? numPolys : ~0ul);
+        stats.Printed(released);
+        if (2<=verbosity && pending.Runs())
+            std::cerr << "sorted output used " << std::dec << pending.Runs() << " temporary runs" << std::endl;
+    }
+    return 0;
+}
+
+// up to this order, all decimations are checked for --gold
+#define EXHAUSTIVE_DECIMATION_ORDER 16
+
+//-----------------------------------------------------------------------------
+static GF2Words PolyWords(uint64_t poly)
+//  from mlpolygen notation to GF2Words, with x**0
+//-----------------------------------------------------------------------------
+{
+    GF2Words words(1, (poly << 1) | 1);
+    if (poly >> 63)
+        words.push_back(1);
+    return words;
+}
+
+//-----------------------------------------------------------------------------
+int EnumeratePreferredPairs(unsigned long order, bool kasami, const char* seedVal, unsigned long numPolys, unsigned numThreads, RunStats& stats, int verbosity)
+//  Gold: each preferred pair A B of ML polynomials once, and their product
+//  G, the feedback polynomial of the sum of the two LFSRs, which makes the
+//  Gold family. Kasami: each ML polynomial A, W for alpha**(k*(2**(n/2)+1))
+//  of degree n/2, and their product K for the small Kasami set. With a
+//  seed, only its own pairs.
+//-----------------------------------------------------------------------------
+{
+    LFSRPolynomial<reg_poly_t> poly(1);
+    if (seedVal) {
+        std::string bstr;
+        reg_uint_t val;
+        if (GetUintAsBinaryStr<reg_uint_t>(seedVal,val,bstr)) {
+            std::cerr << "Error converting to uint" << sizeof(reg_uint_t)*8 << ": " << seedVal << std::endl;
+            return -1;
+        }
+        poly = LFSRPolynomial<reg_poly_t>(bstr);
+        if (order && poly.Order() != order) {
+            std::cerr << "Order multiply specified as " << poly.Order() << " and " << order;
+            std::cerr << ", using " << poly.Order() << " from the start value" << std::endl;
+        }
+        order = poly.Order();
+    }
+    if (order < 3 || order > sizeof(reg_poly_t)*8) {
+        std::cerr << "Error: --gold and --kasami are supported for orders 3 to " << sizeof(reg_poly_t)*8 << std::endl;
+        return -1;
+    }
+    if (kasami && order % 2) {
+        std::cerr << "Error: --kasami needs an even order" << std::endl;
+        return -1;
+    }
+    if (!kasami && order % 4 == 0) {
+        std::cerr << "Error: there are no preferred pairs for orders divisible by 4" << std::endl;
+        return -1;
+    }
+    FactorCache<reg_uint_t,reg_float_t>& factorCache = FactorCache<reg_uint_t,reg_float_t>::Shared();
+    const std::vector<reg_uint_t>& factors = factorCache.Primes(order);
+    reg_poly_t seed;
+    if (seedVal) {
+        MLPolyTester<reg_poly_t,reg_uint_t,reg_float_t> polyTester(order, factors, verbosity);
+        if (polyTester.TestPolynomial(poly)) {
+            std::cerr << "Error: " << seedVal << " is not maximal length for order " << order << std::endl;
+            return -1;
+        }
+        seed = poly;
+    } else {
+        MLPolyRange<reg_poly_t,reg_uint_t,reg_float_t> range(order, &factorCache);
+        seed = *range.begin();
+    }
+
+    CosetEnumerator cosets;
+    cosets.Init(order, seed.to_ullong(), std::vector<uint64_t>(factors.begin(), factors.end()));
+    PreferredPairs pairs;
+    pairs.Init(order, seed.to_ullong());
+    ThreadPool pool(numThreads);
+
+    // the decimations d of preferred pairs, each with its inverse, as
+    // pairs are printed once from the smaller leader
+    std::vector<uint64_t> decimations;
+    const uint64_t kasamiD = (uint64_t(1) << (order/2)) + 1;
+    if (!kasami) {
+        std::vector<uint64_t> candidates;
+        if (order <= EXHAUSTIVE_DECIMATION_ORDER) {
+            CosetEnumerator all;
+            all.Init(order, seed.to_ullong(), std::vector<uint64_t>(factors.begin(), factors.end()));
+            std::vector<uint64_t> leaders;
+            while (all.NextLeaders(leaders, 4096))
+                candidates.insert(candidates.end(), leaders.begin(), leaders.end());
+        } else {
+            pairs.AlgebraicDecimations(candidates);
+        }
+        if (order <= PreferredPairs::maxSpectrumOrder) {
+            std::vector< std::vector<int32_t> > scratch(pool.Size());
+            std::vector<char> preferred(candidates.size());
+            pool.ParallelFor(unsigned(candidates.size()), [&](unsigned i, unsigned thread) {
+                preferred[i] = pairs.IsPreferred(candidates[i], scratch[thread]);
+            });
+            for (unsigned i=0; i<candidates.size(); i++) {
+                if (preferred[i])
+                    decimations.push_back(candidates[i]);
+            }
+        } else {
+            decimations = candidates;
+        }
+        for (unsigned i=0, num=unsigned(decimations.size()); i<num; i++)
+            decimations.push_back(cosets.Leader(pairs.Inverse(decimations[i])));
+        std::sort(decimations.begin(), decimations.end());
+        decimations.erase(std::unique(decimations.begin(), decimations.end()), decimations.end());
+        if (1<=verbosity) {
+            std::cerr << "order " << std::dec << order << ": " << decimations.size() << " preferred decimations from "
+                << candidates.size() << (order <= EXHAUSTIVE_DECIMATION_ORDER ? "" : " algebraic ones")
+                << (order <= PreferredPairs::maxSpectrumOrder ? ", by their spectrum" : ", unchecked") << std::endl;
+        }
+    }
+
+    const unsigned batchSize = 4096;
+    std::vector<uint64_t> leaders;
+    std::vector<std::string> lines(batchSize);
+    unsigned long linesPrinted = 0;
+    bool more = true;
+    while (more && (!numPolys || linesPrinted<numPolys)) {
+        if (seedVal) {
+            leaders.assign(1, 1);
+            more = false;
+        } else if (!cosets.NextLeaders(leaders, batchSize)) {
+            break;
+        }
+        pool.ParallelFor(unsigned(leaders.size()), [&](unsigned i, unsigned) {
+            const uint64_t k = leaders[i];
+            const uint64_t a = cosets.Polynomial(k);
+            std::ostringstream os;
+            if (kasami) {
+                unsigned degree;
+                const uint64_t w = cosets.MinimalPolynomial(pairs.MulMod(k, kasamiD), degree);
+                GF2Words product;
+                PolyMul(PolyWords(a), PolyWords(w), product);
+                os << LFSRPolynomial<reg_poly_t>(order, reg_poly_t(a)) << " "
+                    << LFSRPolynomial<reg_poly_t>(degree, reg_poly_t(w)) << " " << PolyToHex(product) << "\n";
+            } else {
+                std::vector< std::pair<uint64_t,uint64_t> > partners;
+                for (unsigned j=0; j<decimations.size(); j++) {
+                    const uint64_t partner = cosets.Leader(pairs.MulMod(k, decimations[j]));
+                    if (seedVal || k < partner)
+                        partners.push_back(std::make_pair(partner, decimations[j]));
+                }
+                std::sort(partners.begin(), partners.end());
+                for (unsigned j=0; j<partners.size(); j++) {
+                    if (j && partners[j].first == partners[j-1].first)
+                        continue;
+                    const uint64_t b = cosets.Polynomial(partners[j].first);
+                    GF2Words product;
+                    PolyMul(PolyWords(a), PolyWords(b), product);
+                    os << LFSRPolynomial<reg_poly_t>(order, reg_poly_t(a)) << " "
+                        << LFSRPolynomial<reg_poly_t>(order, reg_poly_t(b)) << " " << PolyToHex(product);
+                    if (1<=verbosity)
+                        os << "\t# d=" << std::dec << partners[j].second;
+                    os << "\n";
+                }
+            }
+            lines[i] = os.str();
+        });
+        stats.Lap(RunStats::ENUMERATE);
+        for (unsigned i=0; i<leaders.size() && (!numPolys || linesPrinted<numPolys); i++) {
+            size_t begin = 0, end;
+            while ((!numPolys || linesPrinted<numPolys) && (end = lines[i].find('\n', begin)) != std::string::npos) {
+                std::cout.write(lines[i].data()+begin, end+1-begin);
+                begin = end+1;
+                linesPrinted++;
+                stats.Printed();
+            }
+        }
+        stats.Lap(RunStats::OUTPUT);
+    }
+    return 0;
+}
+//-----------------------------------------------------------------------------
+int PrintSparsest(unsigned long order, bool printCountTaps, bool verify, int verbosity)
+//  SparsestTable.h is written by make_sparsest_table.py
+//-----------------------------------------------------------------------------
+{
+    unsigned taps[3];
+    const unsigned numTaps = order>=2 && order<=sparsestMaxOrder ? SparsestTaps(order, taps) : 0;
+    if (!numTaps) {
+        std::cerr << "Error: order " << std::dec << order << " is not in the table, search with --orders="
+            << order << " --min-weight" << std::endl;
+        return -1;
+    }
+
+    std::string hex = TapsToHex(order, taps, numTaps);
+    if (!printCountTaps)
+        std::cout << hex << std::endl;
+    else
+        std::cout << hex << "\t# " << std::dec << numTaps+1 << std::endl;
+    if (!verify)
+        return 0;
+
+    hex = "0x" + hex;
+    if (order <= sizeof(reg_poly_t)*8)
+        return TestSinglePolynomial<reg_poly_t,reg_uint_t,reg_float_t>(hex.c_str(), verbosity);
+#ifdef USING_GMP
+    return TestSinglePolynomial<big_poly_t,big_uint_t,big_float_t>(hex.c_str(), verbosity);
+#else
+    std::cerr << "Maximum order to verify (without bignum/GMP) is " << sizeof(reg_poly_t)*8 << std::endl;
+    return -1;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+struct SweepQueries {
+//-----------------------------------------------------------------------------
+    unsigned long first;    // the first this many ML polynomials
+    bool trinomials;        // all with 2 taps
+    bool minWeight;         // the first with the fewest taps
+    bool count;
+};
+
+template<typename poly_t, typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+std::string SweepOrder(unsigned order, const SweepQueries& queries)
+//  one JSON record. The cache is shared by the threads of the sweep,
+//  and factoring 2**order-1 reuses the primes of its divisor orders.
+//-----------------------------------------------------------------------------
+{
+    FactorCache<uintT,fltT>& factorCache = FactorCache<uintT,fltT>::Shared();
+    typedef MLPolyRange<poly_t,uintT,fltT> Range;
+    std::ostringstream os;
+    os << "{\"order\": " << std::dec << order;
+
+    if (queries.count) {
+        // Euler's totient of 2**order-1, by its distinct primes
+        const std::vector<uintT>& primes = factorCache.Primes(order);
+        uintT phi = ((uintT(1)<<(order-1))-uintT(1))*uintT(2)+uintT(1);
+        for (unsigned i=0; i<primes.size(); i++) {
+            if (primes[i] > uintT(1))
+                phi = phi / primes[i] * (primes[i] - uintT(1));
+        }
+        os << ", \"count\": " << phi / uintT(order);
+    }
+    if (queries.first) {
+        Range range(order, &factorCache);
+        os << ", \"first\": [";
+        unsigned long k = 0;
+        for (typename Range::iterator it=range.begin(); it!=range.end() && k<queries.first; ++it, ++k)
+            os << (k ? ", \"" : "\"") << *it << "\"";
+        os << "]";
+    }
+    std::string minWeight;
+    unsigned minWeightTaps = 0;
+    if (queries.trinomials) {
+        Range range(order, &factorCache);
+        range.SetTaps(2, 2);
+        os << ", \"trinomials\": [";
+        unsigned long k = 0;
+        for (typename Range::iterator it=range.begin(); it!=range.end(); ++it, ++k) {
+            std::ostringstream poly;
+            poly << *it;
+            if (!k) {
+                minWeight = poly.str();
+                minWeightTaps = 2;
+            }
+            os << (k ? ", \"" : "\"") << poly.str() << "\"";
+        }
+        os << "]";
+    }
+    if (queries.minWeight) {
+        for (unsigned taps=2; minWeight.empty() && taps<=order; taps+=2) {
+            Range range(order, &factorCache);
+            range.SetTaps(taps, taps);
+            typename Range::iterator it = range.begin();
+            if (it != range.end()) {
+                std::ostringstream poly;
+                poly << *it;
+                minWeight = poly.str();
+                minWeightTaps = taps;
+            }
+        }
+        os << ", \"min_weight\": \"" << minWeight << "\", \"min_weight_taps\": " << minWeightTaps;
+    }
+    os << "}";
+    return os.str();
+}
+
+//-----------------------------------------------------------------------------
+int SweepOrders(const char* orders, const SweepQueries& queries, bool bignum, unsigned numThreads, int verbosity)
+//  orders is A-B (or just A). They are handed to the threads largest
+//  first, as those take longest, and printed in increasing order.
+//-----------------------------------------------------------------------------
+{
+    unsigned first = 0, last = 0;
+    char dash = 0;
+    std::istringstream is(orders);
+    if (!(is >> first) || (!is.eof() && (!(is >> dash >> last) || dash!='-' || !is.eof())))
+        first = last = 0;
+    if (!dash)
+        last = first;
+    if (first < 2 || last < first) {
+        std::cerr << "Error: expected orders A-B with 2 <= A <= B: " << orders << std::endl;
+        return -1;
+    }
+#ifdef USING_GMP
+    const unsigned maxOrder = sizeof(big_poly_t)*8;
+#else
+    const unsigned maxOrder = sizeof(reg_poly_t)*8;
+#endif
+    if (last > maxOrder) {
+        std::cerr << "Maximum order is " << maxOrder << std::endl;
+        return -1;
+    }
+
+    const unsigned count = last - first + 1;
+    std::vector<std::string> records(count);
+    std::vector<bool> done(count, false);
+    unsigned printed = 0;
+    std::mutex mutex;
+
+    ThreadPool pool(numThreads);
+    pool.ParallelFor(count, [&](unsigned i, unsigned) {
+        const unsigned order = last - i;
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        std::string record;
+        if (order <= sizeof(reg_poly_t)*8 && !bignum)
+            record = SweepOrder<reg_poly_t,reg_uint_t,reg_float_t>(order, queries);
+#ifdef USING_GMP
+        else
+            record = SweepOrder<big_poly_t,big_uint_t,big_float_t>(order, queries);
+#endif
+        std::lock_guard<std::mutex> lock(mutex);
+        if (1<=verbosity)
+            std::cerr << "order " << order << " took " << std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - t0).count() << " seconds" << std::endl;
+        records[order-first].swap(record);
+        done[order-first] = true;
+        for (; printed<count && done[printed]; printed++) {
+            std::cout << records[printed] << std::endl;
+            records[printed].clear();
+        }
+    });
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+int GeneratePolyBlocks(unsigned order, uint64_t first, uint64_t last, unsigned long numPolys, bool inPairs, RunStats& stats, int verbosity, bool printCountTaps, bool sorted, size_t sortMemory, unsigned blockSize)
+//  GeneratePolySequence() without a limit on the taps, for the orders of
+//  BatchPolyTester: each block of candidates from first to last is run
+//  through the stages, and the survivors are printed in order
+//-----------------------------------------------------------------------------
+{
+    FactorCache<reg_uint_t,reg_float_t>& factorCache = FactorCache<reg_uint_t,reg_float_t>::Shared();
+    const std::vector<reg_uint_t>& primes = factorCache.Primes(order);
+    BatchPolyTester polyTester(order, std::vector<uint64_t>(primes.begin(), primes.end()));
+    polyTester.SetStats(&stats);
+
+    SortedPolyWriter<reg_poly_t> pending(order, std::cout, sortMemory);
+    std::vector<uint64_t> block(blockSize ? blockSize : BATCH_DEFAULT_SIZE);
+    const double rangeSize = double(last-first) + 1;
+
+    unsigned long polysFound = 0;
+    uint64_t next = first;
+    bool more = true;
+    while (more && (!numPolys || polysFound<numPolys)) {
+        unsigned num = 0;
+        while (more && num < block.size()) {
+            const uint64_t cand = next;
+            more = cand != last;
+            next++;
+            if (PolyPopCount(cand) & 1)
+                continue;
+            if (inPairs && polyTester.IsAsymmetric(cand)==1) {
+                stats.Prefiltered();
+                continue;
+            }
+            if (2<=verbosity) {
+                std::cerr << "candidate: " << LFSRPolynomial<reg_poly_t>(order, reg_poly_t(cand)) << std::endl;
+            }
+            if (stats.Enumerated())
+                stats.Progress(double(cand-first)/rangeSize);
+            block[num++] = cand;
+        }
+        const unsigned sieved = polyTester.Sieve(&block[0], num);
+        for (unsigned i=sieved; i<num; i++)
+            stats.Prefiltered();
+        stats.Lap(RunStats::ENUMERATE);
+        num = polyTester.Squarings(&block[0], sieved);
+        num = polyTester.Factors(&block[0], num);
+
+        for (unsigned i=0; i<num && (!numPolys || polysFound<numPolys); i++) {
+            const LFSRPolynomial<reg_poly_t> poly(order, reg_poly_t(block[i]));
+            if (sorted) {
+                unsigned long released = pending.Release(&poly, numPolys ? numPolys-polysFound : ~0ul);
+                polysFound += released;
+                stats.Printed(released);
+            }
+            if (!numPolys || polysFound<numPolys) {
+                if (!printCountTaps)
+                    std::cout << poly << std::endl;
+                else
+                    std::cout << poly << "\t# " << std::dec << PolyPopCount(block[i]) << std::endl;
+                polysFound++;
+                stats.Printed();
+            }
+            if (inPairs && polyTester.IsAsymmetric(block[i])==-1) {
+                const LFSRPolynomial<reg_poly_t> dual(order, reg_poly_t(polyTester.Dual(block[i])));
+                if (sorted) {
+                    pending.Defer(dual);
+                } else {
+                    std::cout << dual << std::endl;
+                    polysFound++;
+                    stats.Printed();
+                }
+            }
+        }
+        stats.Lap(RunStats::OUTPUT);
+    }
+    if (sorted) {
+        unsigned long released = pending.Release(0, numPolys ? numPolys-polysFound : ~0ul);
+        stats.Printed(released);
+        if (2<=verbosity && pending.Runs())
+            std::cerr << "sorted output used " << std::dec << pending.Runs() << " temporary runs" << std::endl;
+    }
+    return 0;
+}
+
+template<typename poly_t, typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+int GeneratePolySequence(unsigned long order, const char* startVal, const char* endVal, unsigned long numPolys, bool inPairs, RunStats& stats, int verbosity=0, bool printCountTaps =false, int maximum_taps =-1, int exact_taps =-1, unsigned sparseTaps=SPARSE_DEFAULT_MAX_TAPS, bool sorted =false, size_t sortMemory =SORTED_DEFAULT_MEMORY<<20, const TuneSettings* tuned =0, bool irreducible =false)
+//  with inPairs and sorted, the duals are held back until the enumeration
+//  has passed them, so the output is in order. sparseTaps applies to all
+//  candidates when it was tuned, else only with a limit on the taps.
+//  With irreducible, the reciprocal of each is irreducible too.
+//-----------------------------------------------------------------------------
+{
+    LFSRPolynomial<poly_t> poly(order?order:1); // use a dummy when !order
+    if (startVal) {
+        std::string bstr;
+        uintT val;
+        int result = GetUintAsBinaryStr<uintT>(startVal,val,bstr);
+        if (result) {
+            std::cerr << "Error converting to uint" << sizeof(uintT)*8;
+            std::cerr << ": " << startVal << std::endl;
+            return result;
+        }
+        poly = LFSRPolynomial<poly_t>(bstr);
+    }
+    LFSRPolynomial<poly_t> endPoly(1);
+    if (endVal) {
+        std::string bstr;
+        uintT val;
+        int result = GetUintAsBinaryStr<uintT>(endVal,val,bstr);
+        if (result) {
+            std::cerr << "Error converting to uint" << sizeof(uintT)*8;
+            std::cerr << ": " << endVal << std::endl;
+            return result;
+        }
+        endPoly = LFSRPolynomial<poly_t>(bstr);
+    }
+    if (startVal && endVal) {
+        if (poly.Order() != endPoly.Order()) {
+            std::cerr << "Error: order for start and end values must match (";
+            std::cerr << poly.Order() << " vs " << endPoly.Order() << ")" << std::endl;
+            return -1;
+        }
+    }
+    if (!startVal && endVal) {
+    	poly = LFSRPolynomial<poly_t>(endPoly.Order());
+    }
+    if ((startVal || endVal) && order && (poly.Order() != order)) {
+        std::cerr << "Order multiply specified as " << poly.Order() << " and " << order;
+        std::cerr << ", using " << poly.Order() << " from the start value" << std::endl;
+    }
+    order = poly.Order();
+
+    // with a limit on the taps, only candidates within it are enumerated
+    const bool tapLimited = (maximum_taps != -1 || exact_taps != -1) && order > 1;
+    unsigned minTaps = 0, maxTaps = order;
+    if (maximum_taps != -1) maxTaps = maximum_taps;
+    if (exact_taps != -1) minTaps = maxTaps = exact_taps;
+    if (tapLimited && !poly.is_candidate(minTaps,maxTaps))
+        poly.next_candidate(minTaps,maxTaps);
+
+    if (1<=verbosity && !numPolys) {
+        std::cerr << "Generating " << (irreducible ? "irreducible" : "maximal length")
+            << " polynomials of order " << order << "," << std::endl;
+        LFSRPolynomial<poly_t> opoly = poly;
+        std::cerr << "  from 0x" << opoly;
+        if (endVal) opoly = endPoly;
+        else opoly.SetMax();
+        std::cerr << " to 0x" << opoly;
+        if (inPairs)
+            std::cerr << " (in pairs)";
+        if (tapLimited)
+            std::cerr << " with " << std::dec << minTaps << " to " << maxTaps << " taps";
+        std::cerr << std::endl;
+    }
+
+    // sparse reduction only pays off when searching for few taps,
+    // unless --tune found that it does for more on this CPU
+    const unsigned testerTaps = tapLimited || tuned ? sparseTaps : 0;
+    SparsePolyTester<poly_t,uintT,fltT> polyTester = irreducible
+        ? SparsePolyTester<poly_t,uintT,fltT>(order,std::vector<uintT>(),verbosity,testerTaps)
+        : SparsePolyTester<poly_t,uintT,fltT>(order,verbosity,testerTaps);
+    if (irreducible)
+        polyTester.SetIrreducible();
+    polyTester.SetStats(&stats);
+
+    // the candidates are half of the range, expected polys scale with it
+    LFSRPolynomial<poly_t> rangeStart = poly;
+    LFSRPolynomial<poly_t> rangeEnd = poly;
+    if (endVal) rangeEnd = endPoly;
+    else rangeEnd.SetMax();
+    double log2Range = RangeLog2(rangeStart, rangeEnd);
+    if (!tapLimited) {
+        stats.SetSpace(order, log2Range-1, polyTester.ExpectedLog2()+log2Range-(order-1));
+    } else {
+        // sum of binomial(order-1, taps-1) over the even tap counts
+        double numCands = 0;
+        for (unsigned taps=minTaps+(minTaps&1); taps<=maxTaps && taps<=order; taps+=2) {
+            numCands += exp(lgamma(order) - lgamma(taps) - lgamma(order-taps+1));
+        }
+        stats.SetSpace(order, log2(numCands)+log2Range-(order-1), -1);
+    }
+
+    // without a limit on the taps, orders up to 64 are tested in blocks
+    if (!tapLimited && !irreducible && BATCH_MIN_ORDER <= order && order <= BATCH_MAX_ORDER) {
+        const uint64_t first = static_cast<const poly_t&>(poly).to_ullong();
+        const uint64_t last = static_cast<const poly_t&>(rangeEnd).to_ullong();
+        if (last < first)
+            return 0;
+        return GeneratePolyBlocks(order, first, last, numPolys, inPairs, stats, verbosity,
+            printCountTaps, sorted && inPairs, sortMemory, tuned ? tuned->blockSize : 0);
+    }
+
+    SortedPolyWriter<poly_t> pending(order, std::cout, sortMemory);
+    sorted = sorted && inPairs;
+
+    unsigned long polysFound = 0;
+    while (1) {
+        while (inPairs && (poly.IsAsymmetric()==1) && !poly.end_candidate()) {
+            stats.Prefiltered();
+            if (tapLimited) poly.next_candidate(minTaps,maxTaps);
+            else poly.next_candidate();
+        }
+        if (poly.end_candidate()) { // have we reached the last possible candidate?
+            break;
+        }
+        if (numPolys && polysFound>=numPolys) { // have we already found enough?
+            break;
+        }
+        if (endVal && endPoly<poly) { // have we passed a spec's endVal?
+            break;
+        }
+        if (2<=verbosity) {
+            std::cerr << "candidate: " << poly << std::endl;
+        }
+        if (stats.Enumerated())
+            stats.Progress(RangeFraction(poly, rangeStart, rangeEnd));
+        stats.Lap(RunStats::ENUMERATE);
+        int result = polyTester.TestPolynomial(poly);
+        if (!result) {
+            const unsigned n_taps_set = poly.NumBitsSet();
+            if ((maximum_taps == -1 || n_taps_set <= unsigned(maximum_taps)) &&
+                (exact_taps == -1 || n_taps_set == unsigned(exact_taps))) {
+                if (sorted) {
+                    unsigned long released = pending.Release(&poly, numPolys ? numPolys-polysFound : ~0ul);
+                    polysFound += released;
+                    stats.Printed(released);
+                }
+                if (!numPolys || polysFound<numPolys) {
+                    if (!printCountTaps)
+                        std::cout << poly << std::endl;
+                    else
+                        std::cout << poly << "\t# " << std::dec << n_taps_set << std::endl;
+                    polysFound++;
+                    stats.Printed();
+                }
+                if (inPairs && (poly.IsAsymmetric()==-1)) { // is asymmetric and has more lower bits
+                    if (sorted) {
+                        pending.Defer(poly.SymmetricDual());
+                    } else {
+                        std::cout << poly.SymmetricDual() << std::endl;
+                        polysFound++;
+                        stats.Printed();
+                    }
+                }
+            }
+            stats.Lap(RunStats::OUTPUT);
+        }
+        if (tapLimited) poly.next_candidate(minTaps,maxTaps);
+        else poly.next_candidate();
+    }
+    if (sorted) {
+        unsigned long released = pending.Release(0, numPolys ? numPolys-polysFound : ~0ul);
+        stats.Printed(released);
+        if (2<=verbosity && pending.Runs())
+            std::cerr << "sorted output used " << std::dec << pending.Runs() << " temporary runs" << std::endl;
+    }
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+int RunWorker(const char* address, int verbosity)
+//  each range of the coordinator is searched as with -s and -e (and -p),
+//  with the output collected for the result instead of printed
+//-----------------------------------------------------------------------------
+{
+    WorkClient client(address);
+    RunStats stats(false, 0, false);
+    WorkRange range;
+    unsigned long numRanges = 0;
+    int leased;
+    while ((leased = client.Lease(range)) == 1) {
+        const std::string start = "0x" + range.start, end = "0x" + range.end;
+        std::ostringstream output;
+        std::streambuf* coutBuf = std::cout.rdbuf(output.rdbuf());
+        int result;
+        if (range.order <= sizeof(reg_poly_t)*8)
+            result = GeneratePolySequence<reg_poly_t,reg_uint_t,reg_float_t>(0,start.c_str(),end.c_str(),0,range.inPairs,stats);
+#ifdef USING_GMP
+        else
+            result = GeneratePolySequence<big_poly_t,big_uint_t,big_float_t>(0,start.c_str(),end.c_str(),0,range.inPairs,stats);
+#else
+        else {
+            std::cerr << "Maximum order (without bignum/GMP) is " << sizeof(reg_poly_t)*8 << std::endl;
+            result = -1;
+        }
+#endif
+        std::cout.rdbuf(coutBuf);
+        if (result)
+            return result;
+
+        std::vector<std::string> polys;
+        std::istringstream lines(output.str());
+        std::string line;
+        while (std::getline(lines, line))
+            polys.push_back(line);
+        if (client.Complete(range, polys))
+            return -1;
+        numRanges++;
+        if (1<=verbosity) {
+            std::cerr << "range " << std::hex << range.id << std::dec << " of order " << range.order
+                << ": " << polys.size() << " polynomials" << std::endl;
+        }
+    }
+    if (1<=verbosity)
+        std::cerr << numRanges << " ranges searched" << std::endl;
+    return leased < 0 ? -1 : 0;
+}
+
+
+//-----------------------------------------------------------------------------
+MLPolyOptions::MLPolyOptions(void)
+//-----------------------------------------------------------------------------
+:   bignum(0), verbosity(0), maximum_taps(-1), exact_taps(-1),
+    sparseTaps(SPARSE_DEFAULT_MAX_TAPS), sparseTapsSet(false), tune(false),
+    shiftUp(0), bruteForceNumBits(0), tapListStr(0), numThreads(0),
+    inPairs(false), sorted(false), sortMemory(size_t(SORTED_DEFAULT_MEMORY) << 20),
+    doRandom(false), irreducible(false), printCountTaps(false), findTwoTaps(false),
+    startVal(0), endVal(0), statsJSON(0), servePath(0), coordinatorAddress(0),
+    workerAddress(0), leaseBits(-1), leaseDir(0), leaseSeconds(WORK_DEFAULT_LEASE_SECONDS),
+    emitPoly(0), seed(0), skipSteps(0), substream(0), galois(false), numBits(0),
+    indexFile(0), nextAfter(0), kth(0), buildIndex(false), countRange(false),
+    sweepOrders(0), minWeight(false), cosets(false), gold(false), kasami(false),
+    verify(false), progressSeconds(0), profile(false), factorCacheFile(0),
+    numPolys(0), orderArg(0)
+{
+}
+
+
+//-----------------------------------------------------------------------------
+bool MLPolyNeedsOrder(const MLPolyOptions& opts)
+//-----------------------------------------------------------------------------
+{
+    return !opts.servePath && !opts.workerAddress && !opts.emitPoly && !opts.sweepOrders
+        && opts.sparsestOrders.empty() && opts.testPolys.empty() && opts.periodPolys.empty()
+        && !opts.startVal && !opts.endVal && !opts.nextAfter;
+}
+
+
+//-----------------------------------------------------------------------------
+int MLPolyRun(MLPolyOptions opts)
+//-----------------------------------------------------------------------------
+{
+    int result = 0;
+    int tested = 0;
+
+    if (opts.factorCacheFile) {
+        std::ifstream file(opts.factorCacheFile);
+        if (!file) {
+            std::cerr << "Error opening factor cache " << opts.factorCacheFile << std::endl;
+            return -1;
+        }
+        int loaded = FactorCache<reg_uint_t,reg_float_t>::Shared().Load(file);
+#ifdef USING_GMP
+        file.clear();
+        file.seekg(0);
+        loaded = FactorCache<big_uint_t,big_float_t>::Shared().Load(file);
+#endif
+        if (1<=opts.verbosity)
+            std::cerr << "loaded the factors of 2**n-1 for " << loaded << " orders" << std::endl;
+    }
+    if (opts.servePath) {
+        PolyServer server(opts.verbosity);
+        return server.Serve(opts.servePath);
+    }
+    if (opts.workerAddress) {
+        if (opts.orderArg)
+            std::cerr << "Note: option --worker excludes the argument order" << std::endl;
+        return RunWorker(opts.workerAddress, opts.verbosity);
+    }
+    if (opts.emitPoly) {
+        if (opts.orderArg)
+            std::cerr << "Note: option --emit-sequence excludes the argument order" << std::endl;
+        return EmitSequence(opts.emitPoly, opts.seed, opts.galois, opts.numBits, opts.skipSteps, opts.substream, opts.verbosity);
+    }
+    if (opts.sweepOrders) {
+        if (opts.orderArg)
+            std::cerr << "Note: option --orders excludes the argument order" << std::endl;
+        SweepQueries queries = { opts.numPolys, opts.findTwoTaps, opts.minWeight, opts.countRange };
+        if (!opts.numPolys && !opts.findTwoTaps && !opts.minWeight && !opts.countRange) {
+            queries.first = 1;
+            queries.trinomials = queries.minWeight = queries.count = true;
+        }
+        return SweepOrders(opts.sweepOrders, queries, opts.bignum, opts.numThreads, opts.verbosity);
+    }
+    if (!opts.sparsestOrders.empty()) {
+        if (opts.orderArg)
+            std::cerr << "Note: option --sparsest excludes the argument order" << std::endl;
+        for (unsigned i=0; i<opts.sparsestOrders.size(); i++)
+            result += PrintSparsest(opts.sparsestOrders[i], opts.printCountTaps, opts.verify, opts.verbosity);
+        return result;
+    }
+    MLPolyIndex index;
+    if (opts.indexFile && !opts.buildIndex)
+        index.Open(opts.indexFile, opts.verbosity);
+
+    for (unsigned i=0; i<opts.testPolys.size(); i++) {
+        if (!opts.testPolys[i].second) {
+            result += TestSinglePolynomial<reg_poly_t,reg_uint_t,reg_float_t>(opts.testPolys[i].first, opts.verbosity, &index, opts.numThreads, opts.irreducible);
+#ifdef USING_GMP
+        } else {
+            result += TestSinglePolynomial<big_poly_t,big_uint_t,big_float_t>(opts.testPolys[i].first, opts.verbosity, 0, opts.numThreads, opts.irreducible);
+#endif
+        }
+        tested++;
+    }
+    for (unsigned i=0; i<opts.periodPolys.size(); i++) {
+        if (strcmp(opts.periodPolys[i], "-")) {
+            result += PeriodOfPolynomial(opts.periodPolys[i], opts.verbosity);
+        } else {
+            std::string line;
+            while (std::cin >> line)
+                result += PeriodOfPolynomial(line.c_str(), opts.verbosity);
+        }
+        tested++;
+    }
+    if (tested) {
+        if (opts.orderArg) {
+            std::cerr << "Note: options -t and --period exclude the argument order" << std::endl;
+        }
+        return result;
+    }
+    unsigned long order = 0;
+    if (opts.orderArg) {
+        char* endp;
+        order = strtoul(opts.orderArg,&endp,0);
+        if (endp[0]) {
+            std::cerr << "Error converting to uint: " << opts.orderArg << std::endl;
+            return -1;
+        }
+    } else if (MLPolyNeedsOrder(opts)) {
+        std::cerr << "Error: not enough arguments" << std::endl;
+        return -1;
+    }
+    // -2 of a Mersenne exponent uses neither type of poly, so it has no limit
+    const bool mersenneTwoTaps = opts.findTwoTaps && IsMersenneExponent(order);
+    if (order>sizeof(reg_poly_t)*8 && !opts.bignum && !mersenneTwoTaps) {
+        std::cerr << "Maximum order (without bignum/GMP) is " << sizeof(reg_poly_t)*8;
+#ifdef USING_GMP
+        std::cerr << ", setting bignum" << std::endl;
+        opts.bignum = 1;
+    }
+    if (order>sizeof(big_poly_t)*8 && !mersenneTwoTaps) {
+        std::cerr << "Maximum order is " << sizeof(big_poly_t)*8;
+#endif
+        std::cerr << std::endl;
+        return -1;
+    }
+
+    if (opts.irreducible && (opts.buildIndex || opts.kth || opts.nextAfter || opts.countRange || opts.findTwoTaps || opts.bruteForceNumBits
+            || opts.tapListStr || opts.cosets || opts.gold || opts.kasami || opts.coordinatorAddress || opts.tune)) {
+        std::cerr << "Error: option --irreducible applies only to -t, -r and the search of order" << std::endl;
+        return -1;
+    }
+
+    if (opts.tune)
+        return TuneAndStore(order, opts.bignum, opts.verbosity);
+
+    // without -k, the setting of --tune for this order, if there is one
+    TuneSettings tuned;
+    const TuneSettings* tunedSettings = 0;
+    if (!opts.sparseTapsSet && order) {
+        TuneCache cache;
+        if (cache.Load() > 0 && cache.Lookup(order, tuned)) {
+            opts.sparseTaps = tuned.sparseTaps;
+            tunedSettings = &tuned;
+            if (1<=opts.verbosity)
+                std::cerr << "using the tuned sparse-taps " << opts.sparseTaps << " for order " << order << std::endl;
+        }
+    }
+
+    if (opts.coordinatorAddress) {
+        const unsigned bits = opts.leaseBits>=0 ? unsigned(opts.leaseBits) : WorkCoordinator::DefaultBits(order);
+        if (order < 2 || bits >= order || bits > WORK_MAX_BITS) {
+            std::cerr << "Error: --lease-bits must be below the order, and at most " << WORK_MAX_BITS << std::endl;
+            return -1;
+        }
+        WorkCoordinator coordinator(order, bits, opts.inPairs, opts.leaseDir, opts.leaseSeconds, opts.verbosity);
+        if (coordinator.Restore() < 0)
+            return -1;
+        return coordinator.Serve(opts.coordinatorAddress) < 0 ? -1 : 0;
+    }
+
+    RunStats stats(opts.statsJSON || opts.progressSeconds>0, opts.progressSeconds, opts.profile);
+    RunStats::InstallSignalHandler();
+
+    if (opts.buildIndex) {
+        std::ostringstream defaultName;
+        defaultName << "mlpoly" << order << ".idx";
+        result = MLPolyIndex::Build(opts.indexFile ? opts.indexFile : defaultName.str().c_str(), order, opts.numThreads, stats, opts.verbosity);
+    }
+
+    else if (opts.kth || opts.nextAfter || opts.countRange) {
+        result = QueryPolynomials(index, order, opts.kth, opts.nextAfter, opts.countRange, opts.startVal, opts.endVal);
+    }
+
+    else if (opts.findTwoTaps) {
+        unsigned n_results = 0;
+        if (mersenneTwoTaps)
+            n_results = FindMersenneTrinomials(order, opts.numThreads, stats, opts.verbosity);
+        else if (!opts.bignum)
+            n_results = FindTwoTapPolynomials<reg_poly_t,reg_uint_t,reg_float_t>(order, stats, opts.verbosity, opts.sparseTaps);
+#ifdef USING_GMP
+        else
+            n_results += FindTwoTapPolynomials<big_poly_t,big_uint_t,big_float_t>(order, stats, opts.verbosity, opts.sparseTaps);
+#endif
+        std::cout << "found " << std::dec << n_results << " polynomials with 2 taps, order "
+            << order << " and maximal length" << std::endl;
+    }
+
+    else if (opts.bruteForceNumBits || opts.tapListStr) {
+        std::vector<unsigned> tapList;
+        if (opts.tapListStr) {
+            if (ParseTapList(opts.tapListStr, tapList)) {
+                std::cerr << "Error parsing tap list: " << opts.tapListStr << std::endl;
+                return -1;
+            }
+        } else if (TapWindow(opts.shiftUp, opts.bruteForceNumBits, order, tapList)) {
+            tapList.clear();
+        }
+        unsigned n_results = 0;
+        if (!tapList.empty()) {
+            if (!opts.bignum)
+                n_results = BruteForceFindPolynomials<reg_poly_t,reg_uint_t,reg_float_t>(tapList, order, opts.numPolys, opts.numThreads, stats, opts.verbosity, opts.sparseTaps, opts.maximum_taps, opts.exact_taps);
+#ifdef USING_GMP
+            else
+                n_results += BruteForceFindPolynomials<big_poly_t,big_uint_t,big_float_t>(tapList, order, opts.numPolys, opts.numThreads, stats, opts.verbosity, opts.sparseTaps, opts.maximum_taps, opts.exact_taps);
+#endif
+        }
+        if (opts.tapListStr)
+            std::cout << "found " << std::dec << n_results << " polynomials with all taps - except top - in "
+                << opts.tapListStr << " of order " << order << " and maximal length" << std::endl;
+        else
+            std::cout << "found " << std::dec << n_results << " polynomials with all taps - except top - in "
+                << opts.shiftUp << " .. " << opts.shiftUp + opts.bruteForceNumBits
+                << " of order " << order << " and maximal length" << std::endl;
+    }
+
+    else if (opts.cosets) {
+        if (opts.startVal || opts.endVal)
+            std::cerr << "Note: option --cosets excludes these options: -s -e " << std::endl;
+        result = EnumerateCosets(order, opts.numPolys, opts.inPairs, opts.sorted, opts.sortMemory, opts.numThreads, stats, opts.verbosity);
+    }
+
+    else if (opts.gold || opts.kasami) {
+        if (opts.gold && opts.kasami) {
+            std::cerr << "Error: options --gold and --kasami exclude each other" << std::endl;
+            return -1;
+        }
+        if (opts.endVal || opts.inPairs)
+            std::cerr << "Note: options --gold and --kasami exclude these options: -e -p" << std::endl;
+        result = EnumeratePreferredPairs(order, opts.kasami, opts.startVal, opts.numPolys, opts.numThreads, stats, opts.verbosity);
+    }
+
+    else if (opts.doRandom) {
+        if (opts.inPairs || opts.startVal || opts.endVal)
+            std::cerr << "Note: option -r excludes these options: -p -s -e " << std::endl;
+        if (!opts.numPolys) opts.numPolys = 1;
+        if (order<=sizeof(reg_poly_t)*8 && !opts.bignum) {
+            result = GenerateRandomPolys<reg_poly_t,reg_uint_t,reg_float_t>(order,opts.numPolys,stats,opts.verbosity,opts.irreducible);
+#ifdef USING_GMP
+        } else {
+            result = GenerateRandomPolys<big_poly_t,big_uint_t,big_float_t>(order,opts.numPolys,stats,opts.verbosity,opts.irreducible);
+#endif
+        }
+    }
+    
+    else if (!opts.bignum) {
+        result = GeneratePolySequence<reg_poly_t,reg_uint_t,reg_float_t>(order,opts.startVal,opts.endVal,opts.numPolys,opts.inPairs,stats,opts.verbosity,opts.printCountTaps,opts.maximum_taps,opts.exact_taps,opts.sparseTaps,opts.sorted,opts.sortMemory,tunedSettings,opts.irreducible);
+#ifdef USING_GMP
+    } else {
+        result = GeneratePolySequence<big_poly_t,big_uint_t,big_float_t>(order,opts.startVal,opts.endVal,opts.numPolys,opts.inPairs,stats,opts.verbosity,opts.printCountTaps,opts.maximum_taps,opts.exact_taps,opts.sparseTaps,opts.sorted,opts.sortMemory,tunedSettings,opts.irreducible);
+#endif
+    }
+
+    std::cout.flush();
+    if (opts.statsJSON)
+        stats.WriteJSON(opts.statsJSON);
+    if (opts.profile)
+        stats.WriteProfile(stderr);
+    return result;
+}
@@ -0,0 +1,101 @@
+//=============================================================================
+//  The modes of mlpolygen, behind the options of its command line
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#ifndef MLPolyModes_h
+#define MLPolyModes_h
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+
+//-----------------------------------------------------------------------------
+struct MLPolyOptions {
+//  The parsed command line of mlpolygen, a field per option (see its usage).
+//  Strings are not copied, so they must outlive MLPolyRun. The defaults are
+//  those of the command line without options.
+//-----------------------------------------------------------------------------
+    MLPolyOptions(void);
+
+    int bignum;
+    int verbosity;
+    int maximum_taps;
+    int exact_taps;
+    unsigned sparseTaps;
+    bool sparseTapsSet;     // else a setting of '--tune' may replace it
+    bool tune;
+    int shiftUp;
+    int bruteForceNumBits;
+    const char* tapListStr;
+    unsigned numThreads;
+    bool inPairs;
+    bool sorted;
+    size_t sortMemory;      // bytes
+    bool doRandom;
+    bool irreducible;
+    bool printCountTaps;
+    bool findTwoTaps;
+    const char* startVal;
+    const char* endVal;
+    const char* statsJSON;
+    const char* servePath;
+    const char* coordinatorAddress;
+    const char* workerAddress;
+    int leaseBits;
+    const char* leaseDir;
+    double leaseSeconds;
+    const char* emitPoly;
+    const char* seed;
+    const char* skipSteps;
+    const char* substream;
+    bool galois;
+    uint64_t numBits;
+    const char* indexFile;
+    const char* nextAfter;
+    unsigned long kth;
+    bool buildIndex;
+    bool countRange;
+    const char* sweepOrders;
+    bool minWeight;
+    bool cosets;
+    bool gold;
+    bool kasami;
+    std::vector< std::pair<const char*,int> > testPolys; // with bignum at the time
+    std::vector<const char*> periodPolys;
+    std::vector<unsigned long> sparsestOrders;
+    bool verify;
+    double progressSeconds;
+    bool profile;
+    const char* factorCacheFile;
+    unsigned long numPolys;
+    const char* orderArg;   // the argument order, 0 if there is none
+};
+
+// runs the mode the options select, returns the exit status of mlpolygen
+int MLPolyRun(MLPolyOptions opts);
+
+// whether that mode needs the argument order
+bool MLPolyNeedsOrder(const MLPolyOptions& opts);
+
+#endif
@@ -0,0 +1,152 @@
+//=============================================================================
+//  A lazy range over the maximal length polynomials of an order
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#ifndef MLPolyRange_h
+#define MLPolyRange_h
+#pragma once
+
+#include "SparsePolyTester.h"
+#include "FactorCache.h"
+
+#include <iterator>
+#include <cstddef>
+
+
+template<typename poly_t=default_poly_t, typename uintT=uintmax_t, typename fltT=long double>
+//-----------------------------------------------------------------------------
+class MLPolyRange {
+//  Enumerates the candidates in increasing order, from start (default the
+//  smallest) to end (default the largest), and tests them only as the
+//  iterator is advanced, like the linear method of the command line:
+//
+//      MLPolyRange<> range(16);
+//      for (MLPolyRange<>::iterator it=range.begin(); it!=range.end(); ++it)
+//          std::cout << *it << std::endl;
+//
+//  The iterators of a range share its tester, so use one range per thread.
+//-----------------------------------------------------------------------------
+  public:
+    MLPolyRange(unsigned order, FactorCache<uintT,fltT>* cache=0);
+
+    void SetStart(const LFSRPolynomial<poly_t>& poly) { start = poly; }
+    void SetEnd(const LFSRPolynomial<poly_t>& poly) { last = poly; hasEnd = true; }
+    void SetTaps(unsigned minTaps, unsigned maxTaps); // only these tap counts
+
+    unsigned Order(void) const { return order; }
+
+    class iterator {
+      public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef LFSRPolynomial<poly_t> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const value_type* pointer;
+        typedef const value_type& reference;
+
+        iterator() : range(0), poly(1) {}
+        reference operator*(void) const { return poly; }
+        pointer operator->(void) const { return &poly; }
+        iterator& operator++(void) { range->Next(poly); Find(); return *this; }
+        bool operator==(const iterator& it) const { return range==it.range; }
+        bool operator!=(const iterator& it) const { return range!=it.range; }
+
+      private:
+        friend class MLPolyRange;
+        iterator(MLPolyRange* r, const value_type& p) : range(r), poly(p) { Find(); }
+        void Find(void) { if (!range->Find(poly)) range = 0; }
+
+        MLPolyRange* range;
+        value_type poly;
+    };
+
+    iterator begin(void) { return iterator(this, start); }
+    iterator end(void) { return iterator(); }
+
+  private:
+    // moves poly to the next ML polynomial from poly on, false past the end
+    bool Find(LFSRPolynomial<poly_t>& poly);
+    void Next(LFSRPolynomial<poly_t>& poly) const;
+
+    unsigned order;
+    SparsePolyTester<poly_t,uintT,fltT> tester;
+    LFSRPolynomial<poly_t> start, last;
+    bool hasEnd;
+    bool tapLimited;
+    unsigned minTaps, maxTaps;
+};
+
+
+//=============================================================================
+//  template implementation
+//=============================================================================
+
+template<typename poly_t, typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+MLPolyRange<poly_t,uintT,fltT>::MLPolyRange(unsigned ord, FactorCache<uintT,fltT>* cache)
+//  without a cache, 2**order-1 is factored here
+//-----------------------------------------------------------------------------
+:   order(ord),
+    tester(cache ? SparsePolyTester<poly_t,uintT,fltT>(ord, cache->Primes(ord), 0, 0)
+                 : SparsePolyTester<poly_t,uintT,fltT>(ord, 0, 0)),
+    start(ord), last(ord), hasEnd(false), tapLimited(false), minTaps(0), maxTaps(ord)
+{
+}
+
+template<typename poly_t, typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+void MLPolyRange<poly_t,uintT,fltT>::SetTaps(unsigned mnTaps, unsigned mxTaps)
+//  sparse reduction pays off only when searching for few taps
+//-----------------------------------------------------------------------------
+{
+    minTaps = mnTaps;
+    maxTaps = mxTaps;
+    tapLimited = order > 1;
+    tester.SetMaxTaps(tapLimited ? SPARSE_DEFAULT_MAX_TAPS : 0);
+}
+
+template<typename poly_t, typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+void MLPolyRange<poly_t,uintT,fltT>::Next(LFSRPolynomial<poly_t>& poly) const
+//-----------------------------------------------------------------------------
+{
+    if (tapLimited) poly.next_candidate(minTaps,maxTaps);
+    else poly.next_candidate();
+}
+
+template<typename poly_t, typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+bool MLPolyRange<poly_t,uintT,fltT>::Find(LFSRPolynomial<poly_t>& poly)
+//-----------------------------------------------------------------------------
+{
+    if (tapLimited && !poly.is_candidate(minTaps,maxTaps))
+        Next(poly);
+    while (1) {
+        if (poly.end_candidate())
+            return false;
+        if (hasEnd && last<poly)
+            return false;
+        if (!tester.TestPolynomial(poly))
+            return true;
+        Next(poly);
+    }
+}
+
+#endif
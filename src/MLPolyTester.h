@@ -27,8 +27,13 @@
 #include "LFSRPolynomial.h"
 #include "LFSRVector.h"
 #include "PrimeFactorizer.h"
+#include "FactorCache.h"
+#include "RunStats.h"
+#include "GF2Factor.h"
 
 #include <stdint.h>
+#include <math.h>
+#include <atomic>
 
 
 #ifdef _MSC_VER
@@ -50,15 +55,57 @@ template<typename poly_t=default_poly_t, typename uintT=uintmax_t, typename fltT
 class MLPolyTester : protected MLPolyTesterBase {
   public:
     MLPolyTester(unsigned order, unsigned verbosity=1);
+    // with the distinct prime factors of 2**order-1 known, e.g. from a FactorCache
+    MLPolyTester(unsigned order, const std::vector<uintT>& primes, unsigned verbosity=1);
     
     int TestPolynomial(const poly_t& poly); // see implementation for return values
 
+    // log2 of the number of ML polynomials, phi(2**order-1)/order
+    double ExpectedLog2(void) const { return expectedLog2; }
+
+    void SetStats(RunStats* s) { stats = s; }
+
+    // the threads of pool share the work of each test, see TestStages()
+    void SetThreadPool(ThreadPool* p) { pool = p; }
+
+    // test for irreducible instead of maximal length, see TestSubfields().
+    // Best with the constructor above and no primes, which are not used.
+    void SetIrreducible(void);
+
   protected:
+    int TestStages(const poly_t& poly);
+    int TestSubfields(const poly_t& poly) const;
+    void SetFactors(const std::vector<uintT>& primes);
+
     unsigned order;
     std::vector<poly_t> shifts;
+    double expectedLog2;
+    RunStats* stats;
+    ThreadPool* pool;
+    std::vector<unsigned> subfields; // order/q for the primes q of order
 };
 
 
+template<typename uintT>
+//-----------------------------------------------------------------------------
+double UintLog2(const uintT& v)
+//  approximate log2 for any unsigned integer type, including bignums
+//-----------------------------------------------------------------------------
+{
+    unsigned nbits = 0;
+    for (uintT t = v; t != uintT(0); t >>= 1)
+        nbits++;
+    unsigned shift = nbits>53 ? nbits-53 : 0;
+    uintT top = v >> shift;
+    double d = 0, w = 1;
+    for (unsigned bit=0; bit<nbits-shift; bit++, w*=2) {
+        if (((top >> bit) & uintT(1)) != uintT(0))
+            d += w;
+    }
+    return log2(d) + shift;
+}
+
+
 //=============================================================================
 //  template implementation
 //=============================================================================
@@ -68,12 +115,20 @@ template<typename poly_t, typename uintT, typename fltT>
 //-----------------------------------------------------------------------------
 MLPolyTester<poly_t,uintT,fltT>::MLPolyTester(unsigned ord, unsigned verbsty)
 //-----------------------------------------------------------------------------
-:   MLPolyTesterBase(verbsty), order(ord)
+:   MLPolyTesterBase(verbsty), order(ord), stats(0), pool(0)
 {
     dbprintf(3, "entering %s\n", __PRETTY_FUNCTION__);
 
+    // e.g. loaded from a file of PrimeFactorizer -s
+    FactorCache<uintT,fltT>& cache = FactorCache<uintT,fltT>::Shared();
+    if (cache.Has(ord)) {
+        dbprintf(2, "Using the cached prime factors of 2**%u-1\n", order);
+        SetFactors(cache.Primes(ord));
+        return;
+    }
+
     dbprintf(2, "Finding prime factors for 2**%u-1\n", order);
-    uintT maxLen = ((uintT(1))<<ord)-uintT(1);
+    uintT maxLen = ((uintT(1)<<(ord-1))-uintT(1))*uintT(2)+uintT(1);
     PrimeFactorizer<uintT,fltT> factorizer(maxLen);
     unsigned numFactors = factorizer.Primes().size();
     dbprintf(2, "Found %d unique prime factors\n", numFactors);
@@ -83,9 +138,31 @@ MLPolyTester<poly_t,uintT,fltT>::MLPolyTester(unsigned ord, unsigned verbsty)
         std::cerr << maxLen << " = " << factorizer << std::endl;
     }
     
+    SetFactors(factorizer.Primes());
+}
+
+template<typename poly_t, typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+MLPolyTester<poly_t,uintT,fltT>::MLPolyTester(unsigned ord, const std::vector<uintT>& primes, unsigned verbsty)
+//-----------------------------------------------------------------------------
+:   MLPolyTesterBase(verbsty), order(ord), stats(0), pool(0)
+{
+    SetFactors(primes);
+}
+
+template<typename poly_t, typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+void MLPolyTester<poly_t,uintT,fltT>::SetFactors(const std::vector<uintT>& primes)
+//-----------------------------------------------------------------------------
+{
+    const unsigned ord = order;
+    const unsigned numFactors = primes.size();
+    uintT maxLen = ((uintT(1)<<(ord-1))-uintT(1))*uintT(2)+uintT(1);
+
     // compute the shifts, which are maxLen / factor[i]
+    shifts.clear();
     for (unsigned i=0; i<numFactors; i++) {
-        uintT newUint = maxLen / factorizer.Primes()[i];
+        uintT newUint = maxLen / primes[i];
 //      poly_t newPoly( newUint );
         poly_t newPoly;
         // to get from an arbitrary integer to a poly, loop over the bits
@@ -95,6 +172,67 @@ MLPolyTester<poly_t,uintT,fltT>::MLPolyTester(unsigned ord, unsigned verbsty)
         }
         shifts.push_back( newPoly );
     }
+
+    // phi(N) = N * prod(1-1/p) over the distinct primes p of N
+    expectedLog2 = ord + log2(1 - exp2(-double(ord)));
+    for (unsigned i=0; i<numFactors; i++) {
+        if (primes[i] != uintT(1))
+            expectedLog2 += log2(1 - exp2(-UintLog2(primes[i])));
+    }
+    expectedLog2 -= log2(double(ord));
+}
+
+template<typename poly_t, typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+void MLPolyTester<poly_t,uintT,fltT>::SetIrreducible(void)
+//  there are about 2**order/order irreducible polynomials
+//-----------------------------------------------------------------------------
+{
+    shifts.clear();
+    subfields.clear();
+    unsigned n = order;
+    for (unsigned q=2; q<=n; q++) {
+        if (n % q)
+            continue;
+        subfields.push_back(order/q);
+        while (n % q == 0)
+            n /= q;
+    }
+    expectedLog2 = order - log2(double(order));
+}
+
+template<typename poly_t, typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+int MLPolyTester<poly_t,uintT,fltT>::TestSubfields(const poly_t& poly) const
+//  Rabin's test: with x**(2**order) = x mod p, p is irreducible unless it
+//  has a factor in a subfield, of a degree dividing order/q for a prime q.
+//  Those are the common factors of p and x**(2**(order/q)) - x. Only the
+//  few candidates that get here are converted to GF2Words.
+//  returns 0 if irreducible, -3 if not
+//-----------------------------------------------------------------------------
+{
+    // bit i is x**(i+1), and x**0 is implied
+    GF2Words p(order/64+1, 0);
+    p[0] = 1;
+    for (unsigned i=0; i<order; i++) {
+        if (poly[i])
+            p[(i+1)/64] |= uint64_t(1) << ((i+1)%64);
+    }
+    GF2Words exponent, xPow, g;
+    for (unsigned k=0; k<subfields.size(); k++) {
+        const unsigned d = subfields[k];
+        exponent.assign(d/64+1, 0);
+        exponent[d/64] = uint64_t(1) << (d%64);
+        PolyPowXMod(p, exponent, xPow);
+        if (xPow.empty())
+            xPow.push_back(0);
+        xPow[0] ^= 2; // minus x
+        PolyTrim(xPow);
+        PolyGcd(p, xPow, g);
+        if (!PolyIsOne(g))
+            return -3;
+    }
+    return 0;
 }
 
 template<typename poly_t, typename uintT, typename fltT>
@@ -104,30 +242,76 @@ int MLPolyTester<poly_t,uintT,fltT>::TestPolynomial(const poly_t& poly)
 //         -1 if order-1 self-feedbacks returns to the initial polynomial
 //         -2 if order self-feedbacks does *not* return to the initial polynomial
 //         -3 if polynomial failed the factors test
+//  With SetIrreducible(), 0 if it is irreducible, and -3 if it failed the
+//  subfields test instead.
+//-----------------------------------------------------------------------------
+{
+    int result = TestStages(poly);
+    if (stats)
+        stats->Tested(result);
+    return result;
+}
+
+template<typename poly_t, typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+int MLPolyTester<poly_t,uintT,fltT>::TestStages(const poly_t& poly)
+//  With a pool, each squaring splits its rows among the threads. The
+//  factor checks are independent, so with at least as many of them as
+//  threads, they run at once, each on one thread, else one at a time
+//  with split squarings.
 //-----------------------------------------------------------------------------
 {
     LFSRVector<poly_t> theVec(order,poly);
     poly_t initialValue = theVec[0];
+    ThreadPool* const rowPool = pool && pool->Size()>1 ? pool : 0;
 
     for (unsigned i=0; i < order-1; i++) {
-        theVec.DoFeedback(theVec);
-        if (theVec[0] == initialValue) return -1;
+        theVec.DoFeedback(theVec, rowPool);
+        if (theVec[0] == initialValue) {
+            if (stats) stats->Lap(RunStats::SQUARING);
+            return -1;
+        }
     }
     // on the orderth case, we should return to the initial value
-    theVec.DoFeedback(theVec);
+    theVec.DoFeedback(theVec, rowPool);
+    if (stats) stats->Lap(RunStats::SQUARING);
     if (theVec[0] != initialValue) return -2;
-    
+
+    if (!subfields.empty()) {
+        int result = TestSubfields(poly);
+        if (stats) stats->Lap(RunStats::FACTORS);
+        return result;
+    }
+
     // passes preliminary test, now check the factors
     if (shifts.size() > 1) {
         poly_t result;
         result[order-1] = 1;
-        for (int k=0; k<shifts.size(); k++) {
-            theVec.DoMultiShifts(poly_t(shifts[k]), poly);
-            if (theVec[0] == result) {
+        if (rowPool && shifts.size() >= rowPool->Size()) {
+            std::atomic<bool> failed(false);
+            std::vector< LFSRVector<poly_t> > vecs(rowPool->Size(), theVec);
+            rowPool->ParallelFor(unsigned(shifts.size()), [&](unsigned k, unsigned thread) {
+                if (failed.load(std::memory_order_relaxed))
+                    return;
+                vecs[thread].DoMultiShifts(poly_t(shifts[k]), poly);
+                if (vecs[thread][0] == result)
+                    failed = true;
+            });
+            if (failed) {
+                if (stats) stats->Lap(RunStats::FACTORS);
                 return -3;
             }
+        } else {
+            for (int k=0; k<shifts.size(); k++) {
+                theVec.DoMultiShifts(poly_t(shifts[k]), poly, rowPool);
+                if (theVec[0] == result) {
+                    if (stats) stats->Lap(RunStats::FACTORS);
+                    return -3;
+                }
+            }
         }
     }
+    if (stats) stats->Lap(RunStats::FACTORS);
 
     // passed all tests
     return 0;
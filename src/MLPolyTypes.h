@@ -0,0 +1,45 @@
+//=============================================================================
+//  The polynomial and integer types for regular and bignum orders
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#ifndef MLPolyTypes_h
+#define MLPolyTypes_h
+#pragma once
+
+#ifdef USING_GMP
+#include <gmpxx.h>
+#endif
+
+#include "LFSRPolynomial.h"
+
+#include <stdint.h>
+
+typedef default_poly_t reg_poly_t;
+typedef uintmax_t reg_uint_t;
+typedef long double reg_float_t;
+
+#ifdef USING_GMP
+typedef std::bitset<1024> big_poly_t;
+typedef mpz_class big_uint_t;
+typedef mpf_class big_float_t;
+#endif
+
+#endif
@@ -0,0 +1,187 @@
+//=============================================================================
+//  Hardware performance counters of the calling thread
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "PerfCounters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#endif
+
+static const char* eventNames[PerfCounters::NUM_EVENTS] = {
+    "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses"
+};
+
+
+#ifdef __linux__
+//-----------------------------------------------------------------------------
+static int OpenEvent(uint32_t type, uint64_t config, int groupFd)
+//  the leader starts disabled, the group is enabled at once
+//-----------------------------------------------------------------------------
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = groupFd < 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return int(syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0));
+}
+#endif
+
+//-----------------------------------------------------------------------------
+PerfCounters::PerfCounters()
+//-----------------------------------------------------------------------------
+:   numOpen(0)
+{
+    for (unsigned e=0; e<NUM_EVENTS; e++) {
+        fds[e] = index[e] = -1;
+        last[e] = 0;
+    }
+}
+
+//-----------------------------------------------------------------------------
+PerfCounters::PerfCounters(const PerfCounters&)
+//-----------------------------------------------------------------------------
+:   numOpen(0)
+{
+    for (unsigned e=0; e<NUM_EVENTS; e++) {
+        fds[e] = index[e] = -1;
+        last[e] = 0;
+    }
+}
+
+//-----------------------------------------------------------------------------
+PerfCounters::~PerfCounters()
+//-----------------------------------------------------------------------------
+{
+    Close();
+}
+
+//-----------------------------------------------------------------------------
+bool PerfCounters::Open(void)
+//-----------------------------------------------------------------------------
+{
+    Close();
+#ifdef __linux__
+    const uint32_t types[NUM_EVENTS] = {
+        PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE,
+        PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE
+    };
+    const uint64_t configs[NUM_EVENTS] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+    };
+    int leader = -1, firstErrno = 0;
+    for (unsigned e=0; e<NUM_EVENTS; e++) {
+        fds[e] = OpenEvent(types[e], configs[e], leader);
+        if (fds[e] < 0) {
+            if (!firstErrno)
+                firstErrno = errno;
+            continue;
+        }
+        if (leader < 0)
+            leader = fds[e];
+        index[e] = int(numOpen++);
+    }
+    if (!numOpen) {
+        error = strerror(firstErrno);
+        if (firstErrno == EACCES || firstErrno == EPERM)
+            error += " (see /proc/sys/kernel/perf_event_paranoid)";
+        else if (firstErrno == ENOENT || firstErrno == ENODEV || firstErrno == EOPNOTSUPP)
+            error = "no hardware events here (virtual machine or container?)";
+        else if (firstErrno == ENOSYS)
+            error = "no perf_event_open in this kernel";
+        return false;
+    }
+    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    return true;
+#else
+    error = "not supported on this platform";
+    return false;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+void PerfCounters::Close(void)
+//-----------------------------------------------------------------------------
+{
+#ifdef __linux__
+    // members before the leader
+    for (int e=NUM_EVENTS-1; e>=0; e--) {
+        if (fds[e] >= 0)
+            close(fds[e]);
+    }
+#endif
+    for (unsigned e=0; e<NUM_EVENTS; e++) {
+        fds[e] = index[e] = -1;
+        last[e] = 0;
+    }
+    numOpen = 0;
+}
+
+//-----------------------------------------------------------------------------
+bool PerfCounters::Read(uint64_t counts[NUM_EVENTS])
+//-----------------------------------------------------------------------------
+{
+#ifdef __linux__
+    if (!numOpen)
+        return false;
+    int leader = -1;
+    for (unsigned e=0; e<NUM_EVENTS && leader<0; e++)
+        leader = fds[e];
+
+    // the number of events, then their values in the order they were added
+    uint64_t values[NUM_EVENTS+1];
+    const ssize_t size = ssize_t((numOpen+1)*sizeof(uint64_t));
+    if (read(leader, values, size) != size)
+        return false;
+    for (unsigned e=0; e<NUM_EVENTS; e++) {
+        if (index[e] < 0)
+            continue;
+        const uint64_t value = values[index[e]+1];
+        counts[e] += value - last[e];
+        last[e] = value;
+    }
+    return true;
+#else
+    (void)counts;
+    return false;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+const char* PerfCounters::Name(Event e)
+//-----------------------------------------------------------------------------
+{
+    return eventNames[e];
+}
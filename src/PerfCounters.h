@@ -0,0 +1,68 @@
+//=============================================================================
+//  Hardware performance counters of the calling thread
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#ifndef PerfCounters_h
+#define PerfCounters_h
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+
+//-----------------------------------------------------------------------------
+class PerfCounters {
+//  counts the events of the thread that calls Open(), in user space,
+//  with Linux perf_event_open. The events are one group, so they are
+//  read together with a single system call. Events the CPU or the
+//  kernel does not offer are left out; inside containers or with a
+//  restrictive perf_event_paranoid often none are, and Open() fails
+//  with the reason in Error(). Elsewhere than Linux it always fails.
+//-----------------------------------------------------------------------------
+  public:
+    enum Event { CYCLES=0, INSTRUCTIONS, L1D_MISSES, LLC_MISSES, BRANCH_MISSES, NUM_EVENTS };
+
+    PerfCounters();
+    PerfCounters(const PerfCounters&);  // a copy is not open
+    ~PerfCounters();
+
+    bool Open(void);
+    void Close(void);
+    bool IsOpen(void) const { return numOpen > 0; }
+    bool Has(Event e) const { return index[e] >= 0; }
+    const std::string& Error(void) const { return error; }
+
+    // adds the events since the last call (or Open) to counts
+    bool Read(uint64_t counts[NUM_EVENTS]);
+
+    static const char* Name(Event e);
+
+  private:
+    PerfCounters& operator=(const PerfCounters&);
+
+    int fds[NUM_EVENTS];
+    int index[NUM_EVENTS];  // position in the group, -1 if not counted
+    unsigned numOpen;
+    uint64_t last[NUM_EVENTS];
+    std::string error;
+};
+
+#endif
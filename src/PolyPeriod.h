@@ -0,0 +1,149 @@
+//=============================================================================
+//  The period of an LFSR: the multiplicative order of x modulo its polynomial
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#ifndef PolyPeriod_h
+#define PolyPeriod_h
+#pragma once
+
+#include "MLPolyTypes.h"
+#include "GF2Factor.h"
+#include "FactorCache.h"
+
+#include <vector>
+
+
+inline uint32_t Low32(const reg_uint_t& v) { return uint32_t(v & 0xFFFFFFFFu); }
+#ifdef USING_GMP
+inline uint32_t Low32(const big_uint_t& v) { return uint32_t(big_uint_t(v & 0xFFFFFFFFu).get_ui()); }
+#endif
+
+
+template<typename uintT=reg_uint_t, typename fltT=reg_float_t>
+//-----------------------------------------------------------------------------
+class PolyPeriod {
+//  The period of the (nonzero) states of an LFSR with polynomial p is the
+//  order of x modulo p, if p has x**0. For an irreducible factor f of
+//  degree d it divides 2**d-1, and is found by dividing out the primes of
+//  2**d-1 (from the cache) while x**(m/q) is still 1 modulo f. A factor
+//  f**e has that order times the smallest power of 2 >= e, and the
+//  period of p is the least common multiple over its factors. Without
+//  x**0 there is no period, as the states are not all reached again.
+//  p is ML exactly if the period is 2**n-1.
+//-----------------------------------------------------------------------------
+  public:
+    PolyPeriod(FactorCache<uintT,fltT>& c) : cache(c) {}
+
+    // false if p lacks x**0 or has order 0
+    bool Compute(const GF2Words& p);
+
+    const uintT& Period(void) const { return period; }
+    const std::vector<GF2Factor>& Factors(void) const { return factors; }
+    // of each factor, with its multiplicity
+    const std::vector<uintT>& FactorOrders(void) const { return orders; }
+
+  private:
+    uintT OrderOfX(const GF2Words& f);
+    static void ToWords(uintT v, GF2Words& words);
+
+    FactorCache<uintT,fltT>& cache;
+    uintT period;
+    std::vector<GF2Factor> factors;
+    std::vector<uintT> orders;
+};
+
+
+//=============================================================================
+//  template implementation
+//=============================================================================
+
+template<typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+void PolyPeriod<uintT,fltT>::ToWords(uintT v, GF2Words& words)
+//  in halves of words, which works for all integer types
+//-----------------------------------------------------------------------------
+{
+    words.clear();
+    for (unsigned half=0; v != uintT(0); half++) {
+        if (!(half&1))
+            words.push_back(0);
+        words.back() |= uint64_t(Low32(v)) << 32*(half&1);
+        v >>= 32;
+    }
+}
+
+template<typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+uintT PolyPeriod<uintT,fltT>::OrderOfX(const GF2Words& f)
+//  f irreducible with x**0, of degree d
+//-----------------------------------------------------------------------------
+{
+    const unsigned d = PolyDegree(f);
+    uintT m = ((uintT(1) << (d-1)) - uintT(1)) * uintT(2) + uintT(1);
+    const std::vector<uintT>& primes = cache.Primes(d);
+    GF2Words k, r;
+    for (unsigned i=0; i<primes.size(); i++) {
+        const uintT& q = primes[i];
+        if (q <= uintT(1))
+            continue;
+        while (m % q == uintT(0)) {
+            ToWords(m / q, k);
+            PolyPowXMod(f, k, r);
+            if (!PolyIsOne(r))
+                break;
+            m /= q;
+        }
+    }
+    return m;
+}
+
+template<typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+bool PolyPeriod<uintT,fltT>::Compute(const GF2Words& p)
+//-----------------------------------------------------------------------------
+{
+    period = uintT(0);
+    factors.clear();
+    orders.clear();
+    if (PolyDegree(p) < 1 || !(p[0] & 1))
+        return false;
+
+    PolyFactor(p, factors);
+    period = uintT(1);
+    for (unsigned i=0; i<factors.size(); i++) {
+        uintT order = OrderOfX(factors[i].poly);
+        for (unsigned power=1; power < factors[i].multiplicity; power *= 2)
+            order *= uintT(2);
+        orders.push_back(order);
+
+        // lcm
+        uintT a = period, b = order;
+        while (b != uintT(0)) {
+            uintT t = a % b;
+            a = b;
+            b = t;
+        }
+        period = period / a * order;
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,434 @@
+//=============================================================================
+//  A server answering test and generate requests over a Unix socket
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "PolyServer.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <chrono>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#endif
+
+// longer request lines are refused, to bound the memory per connection
+#define MAX_REQUEST_LINE (1<<20)
+
+// larger counts of random are refused, to bound the time and the reply
+#define MAX_RANDOM_COUNT (1<<16)
+
+static const char* commandNames[PolyServer::NUM_COMMANDS] = { "test", "next", "random", "batch" };
+
+static volatile sig_atomic_t stopRequested = 0;
+
+
+//-----------------------------------------------------------------------------
+LatencyHistogram::LatencyHistogram()
+//-----------------------------------------------------------------------------
+:   count(0), totalMicros(0)
+{
+    for (unsigned b=0; b<NUM_BUCKETS; b++)
+        buckets[b] = 0;
+}
+
+//-----------------------------------------------------------------------------
+void LatencyHistogram::Add(double seconds)
+//  bucket b holds latencies below 2**b microseconds
+//-----------------------------------------------------------------------------
+{
+    uint64_t micros = uint64_t(seconds*1e6);
+    unsigned b = 0;
+    while (b+1 < NUM_BUCKETS && (uint64_t(1)<<b) <= micros)
+        b++;
+    buckets[b]++;
+    count++;
+    totalMicros += micros;
+}
+
+//-----------------------------------------------------------------------------
+void LatencyHistogram::Print(std::ostream& os, const char* name) const
+//-----------------------------------------------------------------------------
+{
+    const uint64_t n = count;
+    os << name << ": " << n << " requests";
+    if (n)
+        os << ", mean " << totalMicros/n << " us";
+    os << std::endl;
+    for (unsigned b=0; b<NUM_BUCKETS; b++) {
+        if (buckets[b])
+            os << "  < " << (uint64_t(1)<<b) << " us: " << buckets[b] << std::endl;
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+static unsigned HexOrder(const std::string& poly)
+//  the position of the top bit, 0 if it is not a hex number
+//-----------------------------------------------------------------------------
+{
+    size_t i = 0;
+    if (poly.size()>2 && poly[0]=='0' && (poly[1]=='x' || poly[1]=='X'))
+        i = 2;
+    while (i<poly.size() && poly[i]=='0')
+        i++;
+    if (i==poly.size() || poly.find_first_not_of("0123456789abcdefABCDEF", i)!=std::string::npos)
+        return 0;
+    char c = poly[i];
+    unsigned digit = c<='9' ? c-'0' : (c|0x20)-'a'+10;
+    unsigned bits = 0;
+    while (digit) {
+        bits++;
+        digit >>= 1;
+    }
+    return unsigned(poly.size()-i-1)*4 + bits;
+}
+
+//-----------------------------------------------------------------------------
+static int CollectPoly(const char* poly, void* user)
+//-----------------------------------------------------------------------------
+{
+    std::vector<std::string>* polys = (std::vector<std::string>*)user;
+    polys->push_back(poly);
+    return 0;
+}
+
+
+//-----------------------------------------------------------------------------
+PolyServer::PolyServer(int verbsty)
+//-----------------------------------------------------------------------------
+:   verbosity(verbsty)
+{
+}
+
+//-----------------------------------------------------------------------------
+PolyServer::~PolyServer()
+//-----------------------------------------------------------------------------
+{
+    std::map<unsigned, mlpg_tester*>::iterator it;
+    for (it=testers.begin(); it!=testers.end(); ++it)
+        mlpg_tester_destroy(it->second);
+}
+
+//-----------------------------------------------------------------------------
+const mlpg_tester* PolyServer::Tester(unsigned order, std::string& error)
+//  the lock is not held while a new order is factored, into the shared
+//  cache that '--factor-cache' fills
+//-----------------------------------------------------------------------------
+{
+    if (!order || order > mlpg_max_order()) {
+        std::ostringstream os;
+        os << "order must be 1 .. " << mlpg_max_order();
+        error = os.str();
+        return 0;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::map<unsigned, mlpg_tester*>::const_iterator it = testers.find(order);
+        if (it != testers.end())
+            return it->second;
+    }
+    mlpg_tester* tester = mlpg_tester_create(order, 0);
+    if (!tester) {
+        error = "cannot create a tester";
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    std::pair<std::map<unsigned, mlpg_tester*>::iterator, bool> ins =
+        testers.insert(std::make_pair(order, tester));
+    if (!ins.second)
+        mlpg_tester_destroy(tester); // another connection was faster
+    return ins.first->second;
+}
+
+//-----------------------------------------------------------------------------
+std::string PolyServer::Handle(const std::string& line)
+//-----------------------------------------------------------------------------
+{
+    std::istringstream is(line);
+    std::string cmd, arg, error;
+    std::ostringstream reply;
+    is >> cmd;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    int command = -1;
+    for (int c=0; c<NUM_COMMANDS; c++) {
+        if (cmd == commandNames[c])
+            command = c;
+    }
+
+    if (command==TEST || command==NEXT) {
+        if (!(is >> arg))
+            return "err missing polynomial";
+        const mlpg_tester* tester = Tester(HexOrder(arg), error);
+        if (!tester)
+            return "err " + error;
+        if (command==TEST) {
+            int result = mlpg_test(tester, arg.c_str());
+            if (result < 0)
+                return "err invalid polynomial";
+            reply << "ok " << result;
+        } else {
+            // the first one from arg on is arg itself, if that is ML
+            std::vector<std::string> polys;
+            if (mlpg_generate(tester, arg.c_str(), 0, 0, 0, 2, CollectPoly, &polys) < 0)
+                return "err invalid polynomial";
+            if (polys.size() && mlpg_test(tester, arg.c_str())==MLPG_ML)
+                polys.erase(polys.begin());
+            reply << "ok " << (polys.size() ? polys[0] : "none");
+        }
+    }
+    else if (command==RANDOM) {
+        unsigned order = 0;
+        unsigned long count = 1;
+        if (!(is >> order))
+            return "err missing order";
+        if (is >> arg) {
+            char* endp;
+            count = strtoul(arg.c_str(), &endp, 0);
+            if (*endp)
+                return "err invalid count";
+            if (count > MAX_RANDOM_COUNT) {
+                reply << "err count above " << MAX_RANDOM_COUNT;
+                return reply.str();
+            }
+        }
+        const mlpg_tester* tester = Tester(order, error);
+        if (!tester)
+            return "err " + error;
+        std::vector<std::string> polys;
+        mlpg_random(tester, count, CollectPoly, &polys);
+        reply << "ok";
+        for (unsigned i=0; i<polys.size(); i++)
+            reply << " " << polys[i];
+    }
+    else if (command==BATCH) {
+        reply << "ok";
+        while (is >> arg) {
+            const mlpg_tester* tester = Tester(HexOrder(arg), error);
+            int result = tester ? mlpg_test(tester, arg.c_str()) : MLPG_EINVAL;
+            if (result < 0)
+                return "err invalid polynomial " + arg;
+            reply << " " << result;
+        }
+    }
+    else if (cmd == "stats") {
+        reply << "ok" << std::endl;
+        PrintStats(reply);
+        reply << ".";
+    }
+    else {
+        return "err unknown command '" + cmd + "'";
+    }
+
+    if (command >= 0) {
+        std::chrono::duration<double> dt = std::chrono::steady_clock::now() - start;
+        latency[command].Add(dt.count());
+    }
+    return reply.str();
+}
+
+//-----------------------------------------------------------------------------
+void PolyServer::PrintStats(std::ostream& os) const
+//-----------------------------------------------------------------------------
+{
+    for (int c=0; c<NUM_COMMANDS; c++)
+        latency[c].Print(os, commandNames[c]);
+}
+
+#ifndef _WIN32
+
+//-----------------------------------------------------------------------------
+static void StopHandler(int)
+//-----------------------------------------------------------------------------
+{
+    stopRequested = 1;
+}
+
+//-----------------------------------------------------------------------------
+static bool SendAll(int fd, const std::string& data)
+//-----------------------------------------------------------------------------
+{
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data()+sent, data.size()-sent, 0);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        sent += n;
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void PolyServer::Connection(int fd)
+//  the fd is closed under the lock, so Serve() never shuts down a reused one
+//-----------------------------------------------------------------------------
+{
+    std::string buffer;
+    char chunk[4096];
+    bool open = true;
+    while (open) {
+        ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            break;
+        buffer.append(chunk, n);
+
+        size_t eol;
+        while (open && (eol = buffer.find('\n')) != std::string::npos) {
+            std::string line = buffer.substr(0, eol);
+            buffer.erase(0, eol+1);
+            if (line.size() && line[line.size()-1]=='\r')
+                line.erase(line.size()-1);
+            if (line == "quit") {
+                open = false;
+                break;
+            }
+            if (2<=verbosity)
+                std::cerr << "request: " << line << std::endl;
+            open = SendAll(fd, Handle(line) + "\n");
+        }
+        if (buffer.size() > MAX_REQUEST_LINE) {
+            SendAll(fd, "err request too long\n");
+            break;
+        }
+    }
+    std::lock_guard<std::mutex> lock(connectionMutex);
+    openFds.erase(fd);
+    close(fd);
+    finished.push_back(std::this_thread::get_id());
+}
+
+//-----------------------------------------------------------------------------
+void PolyServer::JoinFinished(void)
+//-----------------------------------------------------------------------------
+{
+    std::vector<std::thread::id> ids;
+    {
+        std::lock_guard<std::mutex> lock(connectionMutex);
+        ids.swap(finished);
+    }
+    for (unsigned i=0; i<ids.size(); i++) {
+        std::map<std::thread::id, std::thread>::iterator it = threads.find(ids[i]);
+        it->second.join();
+        threads.erase(it);
+    }
+}
+
+//-----------------------------------------------------------------------------
+int PolyServer::Serve(const char* socketPath)
+//-----------------------------------------------------------------------------
+{
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(socketPath) >= sizeof(addr.sun_path)) {
+        std::cerr << "Error: socket path too long: " << socketPath << std::endl;
+        return -1;
+    }
+    strcpy(addr.sun_path, socketPath);
+
+    int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        std::cerr << "Error creating socket: " << strerror(errno) << std::endl;
+        return -1;
+    }
+    // only a socket left by an earlier server is removed
+    struct stat st;
+    if (lstat(socketPath, &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            std::cerr << "Error: " << socketPath << " exists and is not a socket" << std::endl;
+            close(listenFd);
+            return -1;
+        }
+        unlink(socketPath);
+    }
+    if (bind(listenFd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(listenFd, 64) < 0) {
+        std::cerr << "Error binding " << socketPath << ": " << strerror(errno) << std::endl;
+        close(listenFd);
+        return -1;
+    }
+
+    // no SA_RESTART, so that accept() returns on these
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = StopHandler;
+    sigaction(SIGINT, &sa, 0);
+    sigaction(SIGTERM, &sa, 0);
+    signal(SIGPIPE, SIG_IGN);
+
+    if (1<=verbosity)
+        std::cerr << "serving on " << socketPath << std::endl;
+    while (!stopRequested) {
+        int fd = accept(listenFd, 0, 0);
+        if (fd < 0) {
+            if (errno == EINTR)
+                continue;
+            std::cerr << "Error accepting: " << strerror(errno) << std::endl;
+            break;
+        }
+        JoinFinished();
+        std::lock_guard<std::mutex> lock(connectionMutex);
+        openFds.insert(fd);
+        std::thread thread(&PolyServer::Connection, this, fd);
+        threads[thread.get_id()] = std::move(thread);
+    }
+    close(listenFd);
+    unlink(socketPath);
+
+    // the open connections finish their current request, then see the end
+    {
+        std::lock_guard<std::mutex> lock(connectionMutex);
+        for (std::set<int>::const_iterator it=openFds.begin(); it!=openFds.end(); ++it)
+            shutdown(*it, SHUT_RDWR);
+    }
+    std::map<std::thread::id, std::thread>::iterator it;
+    for (it=threads.begin(); it!=threads.end(); ++it)
+        it->second.join();
+    threads.clear();
+    finished.clear();
+
+    PrintStats(std::cerr);
+    return stopRequested ? 0 : -1;
+}
+
+#else
+
+//-----------------------------------------------------------------------------
+int PolyServer::Serve(const char* socketPath)
+//-----------------------------------------------------------------------------
+{
+    std::cerr << "Error: --serve is only supported with Unix sockets" << std::endl;
+    return -1;
+}
+
+#endif
@@ -0,0 +1,107 @@
+//=============================================================================
+//  A server answering test and generate requests over a Unix socket
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#ifndef PolyServer_h
+#define PolyServer_h
+#pragma once
+
+#include "mlpolygen.h"
+
+#include <stdint.h>
+#include <atomic>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+//-----------------------------------------------------------------------------
+class LatencyHistogram {
+//  counts latencies in buckets of powers of two microseconds
+//-----------------------------------------------------------------------------
+  public:
+    enum { NUM_BUCKETS = 32 };
+
+    LatencyHistogram();
+
+    void Add(double seconds);
+    void Print(std::ostream& os, const char* name) const;
+
+  private:
+    std::atomic<uint64_t> buckets[NUM_BUCKETS];
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> totalMicros;
+};
+
+
+//-----------------------------------------------------------------------------
+class PolyServer {
+//  Listens on a Unix domain socket and serves each connection on its own
+//  thread. Requests and replies are single lines:
+//
+//      test POLY            ->  ok 1 (ML) | ok 0 (not ML)
+//      next POLY            ->  ok POLY2, the smallest ML poly above POLY
+//      random ORDER [N]     ->  ok POLY1 .. POLYN, N up to 65536
+//      batch POLY1 .. POLYN ->  ok R1 .. RN, each 1 or 0
+//      stats                ->  ok, then the latency histograms, then "."
+//      quit                 ->  closes the connection
+//
+//  Errors are replied as "err MESSAGE". Testers are created on first use
+//  of an order and kept, so 2**order-1 is factored only once. Serve()
+//  joins the connection threads before it returns.
+//-----------------------------------------------------------------------------
+  public:
+    enum Command { TEST=0, NEXT, RANDOM, BATCH, NUM_COMMANDS };
+
+    PolyServer(int verbosity=0);
+    ~PolyServer();
+
+    // returns when SIGINT or SIGTERM is received, nonzero on errors
+    int Serve(const char* socketPath);
+
+    // one request line without the newline, the reply without it
+    std::string Handle(const std::string& line);
+
+    void PrintStats(std::ostream& os) const;
+
+  private:
+    PolyServer(const PolyServer&);
+    PolyServer& operator=(const PolyServer&);
+
+    const mlpg_tester* Tester(unsigned order, std::string& error);
+    void Connection(int fd);
+    void JoinFinished(void);
+
+    int verbosity;
+    std::mutex mutex;
+    std::map<unsigned, mlpg_tester*> testers;
+    LatencyHistogram latency[NUM_COMMANDS];
+    std::mutex connectionMutex;
+    std::set<int> openFds;
+    std::map<std::thread::id, std::thread> threads;
+    std::vector<std::thread::id> finished;  // to be joined
+};
+
+#endif
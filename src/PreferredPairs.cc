@@ -0,0 +1,183 @@
+//=============================================================================
+//  Preferred pairs of m-sequences, for Gold and Kasami codes
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "PreferredPairs.h"
+
+#include <algorithm>
+
+
+//-----------------------------------------------------------------------------
+static unsigned Gcd(unsigned a, unsigned b)
+//-----------------------------------------------------------------------------
+{
+    while (b) {
+        const unsigned t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+//-----------------------------------------------------------------------------
+PreferredPairs::PreferredPairs()
+//-----------------------------------------------------------------------------
+:   n(0), mask(0), low(0)
+{
+}
+
+//-----------------------------------------------------------------------------
+bool PreferredPairs::Init(unsigned order, uint64_t seed)
+//  s(t) is the top bit of x**t mod p, as for the CosetEnumerator. The
+//  sequence is kept only when its spectrum can be computed.
+//-----------------------------------------------------------------------------
+{
+    if (order < 3 || order > 64 || !((seed >> (order-1)) & 1))
+        return false;
+    n = order;
+    mask = order < 64 ? (uint64_t(1) << order) - 1 : ~uint64_t(0);
+    low = ((seed << 1) | 1) & mask;
+
+    sequence.clear();
+    if (n > maxSpectrumOrder)
+        return true;
+    sequence.assign((mask+63)/64, 0);
+    uint64_t r = 1;
+    for (uint64_t t=0; t<mask; t++) {
+        sequence[t/64] |= ((r >> (n-1)) & 1) << (t%64);
+        r = MulX(r);
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+uint64_t PreferredPairs::MulX(uint64_t r) const
+//-----------------------------------------------------------------------------
+{
+    const uint64_t carry = (r >> (n-1)) & 1;
+    return ((r << 1) & mask) ^ (low & (0-carry));
+}
+
+//-----------------------------------------------------------------------------
+uint64_t PreferredPairs::MulMod(uint64_t a, uint64_t b) const
+//  double and add, as a*b may not fit in 64 bits
+//-----------------------------------------------------------------------------
+{
+    a %= mask;
+    b %= mask;
+    uint64_t result = 0;
+    for (; b; b >>= 1) {
+        if (b & 1)
+            result = result >= mask-a ? result-(mask-a) : result+a;
+        a = a >= mask-a ? a-(mask-a) : a+a;
+    }
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+uint64_t PreferredPairs::Inverse(uint64_t d) const
+//  extended Euclid, with the coefficients of d kept mod 2**n-1
+//-----------------------------------------------------------------------------
+{
+    uint64_t r0 = mask, r1 = d % mask, t0 = 0, t1 = 1;
+    while (r1) {
+        const uint64_t q = r0 / r1, r2 = r0 - q*r1;
+        const uint64_t qt = MulMod(q, t1), t2 = t0 >= qt ? t0-qt : t0+(mask-qt);
+        r0 = r1;
+        r1 = r2;
+        t0 = t1;
+        t1 = t2;
+    }
+    return r0 == 1 ? t0 : 0;
+}
+
+//-----------------------------------------------------------------------------
+uint64_t PreferredPairs::Leader(uint64_t k) const
+//  the smallest of the rotations of the n bits of k
+//-----------------------------------------------------------------------------
+{
+    k %= mask;
+    uint64_t leader = k;
+    for (unsigned i=1; i<n; i++) {
+        k = ((k << 1) | (k >> (n-1))) & mask;
+        if (k < leader)
+            leader = k;
+    }
+    return leader;
+}
+
+//-----------------------------------------------------------------------------
+void PreferredPairs::AlgebraicDecimations(std::vector<uint64_t>& decimations) const
+//-----------------------------------------------------------------------------
+{
+    decimations.clear();
+    const unsigned want = n % 2 ? 1 : 2;
+    if (n % 4 == 0)
+        return;
+    for (unsigned i=1; i<n; i++) {
+        if (Gcd(n, i) != want)
+            continue;
+        const uint64_t twoI = uint64_t(1) << i;             // i < n <= 64
+        decimations.push_back(Leader(twoI + 1));            // Gold
+        decimations.push_back(Leader(MulMod(twoI, twoI) + 1 + mask - twoI)); // Kasami
+    }
+    std::sort(decimations.begin(), decimations.end());
+    decimations.erase(std::unique(decimations.begin(), decimations.end()), decimations.end());
+}
+
+//-----------------------------------------------------------------------------
+bool PreferredPairs::IsPreferred(uint64_t d, std::vector<int32_t>& f) const
+//  f(y) as +1 and -1, for y = alpha**t at index x**t mod p. f(0) is +1
+//  and does not change the values at a != 0. The transform is in place.
+//-----------------------------------------------------------------------------
+{
+    if (sequence.empty())
+        return false;
+    f.assign(size_t(mask)+1, 1);
+    uint64_t r = 1, dt = 0;
+    d %= mask;
+    for (uint64_t t=0; t<mask; t++) {
+        if ((sequence[dt/64] >> (dt%64)) & 1)
+            f[r] = -1;
+        r = MulX(r);
+        dt = dt >= mask-d ? dt-(mask-d) : dt+d;
+    }
+
+    const size_t size = size_t(mask)+1;
+    for (size_t half=1; half<size; half*=2) {
+        for (size_t i=0; i<size; i+=2*half) {
+            for (size_t j=i; j<i+half; j++) {
+                const int32_t a = f[j], b = f[j+half];
+                f[j] = a+b;
+                f[j+half] = a-b;
+            }
+        }
+    }
+
+    // W(a)-1 is -1, -t or t-2
+    const int32_t t = 1 + (int32_t(1) << ((n+2)/2));
+    for (size_t a=1; a<size; a++) {
+        const int32_t c = f[a]-1;
+        if (c != -1 && c != -t && c != t-2)
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,81 @@
+//=============================================================================
+//  Preferred pairs of m-sequences, for Gold and Kasami codes
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#ifndef PreferredPairs_h
+#define PreferredPairs_h
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+
+//-----------------------------------------------------------------------------
+class PreferredPairs {
+//  A pair of m-sequences of order n is preferred when their periodic
+//  cross-correlation takes only the values -1, -t and t-2, with
+//  t = 1+2**floor((n+2)/2). If s is the m-sequence of alpha, the one of
+//  alpha**k is s decimated by k, and the cross-correlation of the pair
+//  alpha**k and alpha**(k*d) is that of s and s(d*t), so it is a
+//  property of the decimation d alone. It is preferred for Gold's
+//  d = 2**i+1 and Kasami's d = 2**(2i)-2**i+1, when gcd(n,i) is 1 for
+//  odd n or 2 for n = 2 mod 4. For n divisible by 4 there are none.
+//
+//  Other decimations are checked by their spectrum: with y = alpha**t
+//  in the polynomial basis of the seed, f(y) = s(d*t) is a function of
+//  n bits. The linear functions of y are the shifts of s (and 0), so
+//  the Walsh transform of f, in n*2**n steps, is 1 plus the cross-
+//  correlation at each shift.
+//
+//  For orders 3 to 64, and to maxSpectrumOrder for the spectrum. Init()
+//  is for one thread, the rest may be called from many at once.
+//-----------------------------------------------------------------------------
+  public:
+    enum { maxSpectrumOrder = 24 };
+
+    PreferredPairs();
+
+    // seed must be ML, in mlpolygen notation
+    bool Init(unsigned order, uint64_t seed);
+
+    // the decimations of Gold and Kasami, up to the cyclotomic cosets
+    // (so d and 2d count once), as their smallest elements
+    void AlgebraicDecimations(std::vector<uint64_t>& decimations) const;
+
+    // the cross-correlation of s and s(d*t) is three-valued as above,
+    // scratch holds 2**n values
+    bool IsPreferred(uint64_t d, std::vector<int32_t>& scratch) const;
+
+    // a*b mod 2**n-1, and the inverse of d (coprime to it)
+    uint64_t MulMod(uint64_t a, uint64_t b) const;
+    uint64_t Inverse(uint64_t d) const;
+
+  private:
+    uint64_t MulX(uint64_t r) const;
+    uint64_t Leader(uint64_t k) const;
+
+    unsigned n;
+    uint64_t mask;          // the n bits of a residue, 2**n-1
+    uint64_t low;           // x**n mod p
+    std::vector<uint64_t> sequence; // the 2**n-1 bits of s
+};
+
+#endif
@@ -0,0 +1,315 @@
+//=============================================================================
+//  A class for run statistics, rejection counters and progress reporting
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "RunStats.h"
+#include <math.h>
+#include <string.h>
+#include <atomic>
+
+// how many candidates between looks at the clock
+static const unsigned CHECK_INTERVAL = 1024;
+
+volatile sig_atomic_t RunStats::progressRequested = 0;
+
+static const char* stageNames[RunStats::NUM_STAGES] = {
+    "enumerate", "squaring", "factors", "output"
+};
+
+
+//-----------------------------------------------------------------------------
+static void FormatCount(char* buf, size_t len, double log2Count)
+//  counts beyond double precision are given as a power of 2
+//-----------------------------------------------------------------------------
+{
+    if (log2Count < 53)
+        snprintf(buf, len, "%.0f", exp2(log2Count));
+    else
+        snprintf(buf, len, "2**%.2f", log2Count);
+}
+
+//-----------------------------------------------------------------------------
+static void FormatSeconds(char* buf, size_t len, double sec)
+//-----------------------------------------------------------------------------
+{
+    if (!(sec < 1e12)) { // also catches NaN
+        snprintf(buf, len, "unknown");
+        return;
+    }
+    unsigned long s = (unsigned long)sec;
+    snprintf(buf, len, "%lu:%02lu:%02lu", s/3600, (s/60)%60, s%60);
+}
+
+#ifdef SIGUSR1
+//-----------------------------------------------------------------------------
+static void ProgressSignalHandler(int)
+//-----------------------------------------------------------------------------
+{
+    RunStats::RequestProgress();
+}
+#endif
+
+
+//-----------------------------------------------------------------------------
+RunStats::RunStats(bool tmng, double progSecs, bool prof)
+//  profiling needs the laps, so it implies timing
+//-----------------------------------------------------------------------------
+:   order(0), timing(tmng || prof), progressSeconds(progSecs),
+    log2Candidates(-1), log2Expected(-1),
+    candidates(0), prefiltered(0), accepted(0), printed(0),
+    untilCheck(CHECK_INTERVAL),
+    profile(prof), countersTried(false), countedThreads(0), countedEvents(0)
+{
+    rejected[0] = rejected[1] = rejected[2] = 0;
+    startTime = lastProgress = lapStart = clock_type::now();
+    for (unsigned s=0; s<NUM_STAGES; s++) {
+        stageTime[s] = clock_type::duration::zero();
+        for (unsigned e=0; e<PerfCounters::NUM_EVENTS; e++)
+            stageCounts[s][e] = 0;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void RunStats::Count(Stage s)
+//  the first failure is reported once for all threads
+//-----------------------------------------------------------------------------
+{
+    if (!countersTried) {
+        countersTried = true;
+        if (counters.Open()) {
+            countedThreads = 1;
+            for (unsigned e=0; e<PerfCounters::NUM_EVENTS; e++) {
+                if (counters.Has(PerfCounters::Event(e)))
+                    countedEvents |= 1u << e;
+            }
+        } else {
+            static std::atomic<bool> reported(false);
+            if (!reported.exchange(true))
+                fprintf(stderr, "Note: hardware counters unavailable: %s, profiling times only\n",
+                    counters.Error().c_str());
+        }
+    }
+    if (counters.IsOpen())
+        counters.Read(stageCounts[s]);
+}
+
+//-----------------------------------------------------------------------------
+void RunStats::SetSpace(unsigned ord, double log2Cands, double log2Exp)
+//-----------------------------------------------------------------------------
+{
+    order = ord;
+    log2Candidates = log2Cands;
+    log2Expected = log2Exp;
+}
+
+//-----------------------------------------------------------------------------
+void RunStats::InstallSignalHandler(void)
+//  SIGUSR1 prints a progress line at the next check
+//-----------------------------------------------------------------------------
+{
+#ifdef SIGUSR1
+    signal(SIGUSR1, ProgressSignalHandler);
+#endif
+}
+
+//-----------------------------------------------------------------------------
+void RunStats::Merge(RunStats& other)
+//-----------------------------------------------------------------------------
+{
+    candidates += other.candidates;
+    prefiltered += other.prefiltered;
+    for (unsigned r=0; r<3; r++) {
+        rejected[r] += other.rejected[r];
+        other.rejected[r] = 0;
+    }
+    accepted += other.accepted;
+    printed += other.printed;
+    for (unsigned s=0; s<NUM_STAGES; s++) {
+        stageTime[s] += other.stageTime[s];
+        other.stageTime[s] = clock_type::duration::zero();
+        for (unsigned e=0; e<PerfCounters::NUM_EVENTS; e++) {
+            stageCounts[s][e] += other.stageCounts[s][e];
+            other.stageCounts[s][e] = 0;
+        }
+    }
+    countedThreads += other.countedThreads;
+    countedEvents |= other.countedEvents;
+    other.countedThreads = other.countedEvents = 0;
+    other.candidates = other.prefiltered = other.accepted = other.printed = 0;
+}
+
+//-----------------------------------------------------------------------------
+bool RunStats::ProgressDue(void)
+//-----------------------------------------------------------------------------
+{
+    untilCheck = CHECK_INTERVAL;
+    if (progressRequested) {
+        progressRequested = 0;
+        return true;
+    }
+    if (progressSeconds <= 0)
+        return false;
+    clock_type::time_point now = clock_type::now();
+    if (std::chrono::duration<double>(now-lastProgress).count() < progressSeconds)
+        return false;
+    lastProgress = now;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+double RunStats::Elapsed(void) const
+//-----------------------------------------------------------------------------
+{
+    return std::chrono::duration<double>(clock_type::now()-startTime).count();
+}
+
+//-----------------------------------------------------------------------------
+void RunStats::Progress(double fraction) const
+//-----------------------------------------------------------------------------
+{
+    double elapsed = Elapsed();
+    double rate = elapsed>0 ? candidates/elapsed : 0;
+    char ebuf[32], tbuf[32], cbuf[32], xbuf[32];
+
+    FormatSeconds(ebuf, sizeof(ebuf), elapsed);
+    fprintf(stderr, "progress: order %u", order);
+    if (fraction>=0)
+        fprintf(stderr, ", %.3f%%", 100*fraction);
+    fprintf(stderr, ", %llu candidates", (unsigned long long)candidates);
+    if (log2Candidates>=0) {
+        FormatCount(cbuf, sizeof(cbuf), log2Candidates);
+        fprintf(stderr, " of ~%s", cbuf);
+    }
+    fprintf(stderr, " (%.0f/s), %llu found", rate, (unsigned long long)accepted);
+    if (log2Expected>=0) {
+        FormatCount(xbuf, sizeof(xbuf), log2Expected);
+        fprintf(stderr, " of ~%s expected", xbuf);
+    }
+    fprintf(stderr, ", elapsed %s", ebuf);
+    if (fraction>0) {
+        FormatSeconds(tbuf, sizeof(tbuf), elapsed*(1-fraction)/fraction);
+        fprintf(stderr, ", ETA %s", tbuf);
+    }
+    fprintf(stderr, "\n");
+}
+
+//-----------------------------------------------------------------------------
+int RunStats::WriteJSON(const char* fileName) const
+//-----------------------------------------------------------------------------
+{
+    FILE* f = stderr;
+    if (strcmp(fileName,"-")) {
+        f = fopen(fileName, "w");
+        if (!f) {
+            fprintf(stderr, "Error opening stats file '%s'\n", fileName);
+            return -1;
+        }
+    }
+    fprintf(f, "{\n");
+    fprintf(f, "  \"order\": %u,\n", order);
+    fprintf(f, "  \"candidates\": %llu,\n", (unsigned long long)candidates);
+    fprintf(f, "  \"prefiltered\": %llu,\n", (unsigned long long)prefiltered);
+    fprintf(f, "  \"rejected\": { \"stage1\": %llu, \"stage2\": %llu, \"stage3\": %llu },\n",
+        (unsigned long long)rejected[0], (unsigned long long)rejected[1],
+        (unsigned long long)rejected[2]);
+    fprintf(f, "  \"accepted\": %llu,\n", (unsigned long long)accepted);
+    fprintf(f, "  \"printed\": %llu,\n", (unsigned long long)printed);
+    if (log2Candidates>=0)
+        fprintf(f, "  \"log2_space\": %.6f,\n", log2Candidates);
+    if (log2Expected>=0)
+        fprintf(f, "  \"log2_expected\": %.6f,\n", log2Expected);
+    if (timing) {
+        fprintf(f, "  \"stage_seconds\": {");
+        for (unsigned s=0; s<NUM_STAGES; s++) {
+            fprintf(f, "%s \"%s\": %.6f", s ? "," : "", stageNames[s],
+                std::chrono::duration<double>(stageTime[s]).count());
+        }
+        fprintf(f, " },\n");
+    }
+    if (countedThreads) {
+        fprintf(f, "  \"stage_counters\": {\n");
+        for (unsigned s=0; s<NUM_STAGES; s++) {
+            fprintf(f, "    \"%s\": {", stageNames[s]);
+            bool first = true;
+            for (unsigned e=0; e<PerfCounters::NUM_EVENTS; e++) {
+                if (!(countedEvents & (1u << e)))
+                    continue;
+                fprintf(f, "%s \"%s\": %llu", first ? "" : ",", PerfCounters::Name(PerfCounters::Event(e)),
+                    (unsigned long long)stageCounts[s][e]);
+                first = false;
+            }
+            fprintf(f, " }%s\n", s+1<NUM_STAGES ? "," : "");
+        }
+        fprintf(f, "  },\n");
+    }
+    fprintf(f, "  \"seconds\": %.6f\n", Elapsed());
+    fprintf(f, "}\n");
+    if (f!=stderr)
+        fclose(f);
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+void RunStats::WriteProfile(FILE* f) const
+//  IPC per stage, and the misses per candidate. Events that were not
+//  counted are shown as -.
+//-----------------------------------------------------------------------------
+{
+    const uint64_t cycles = 1u << PerfCounters::CYCLES;
+    const uint64_t instrs = 1u << PerfCounters::INSTRUCTIONS;
+    const PerfCounters::Event misses[3] = {
+        PerfCounters::L1D_MISSES, PerfCounters::LLC_MISSES, PerfCounters::BRANCH_MISSES
+    };
+    fprintf(f, "profile: order %u, %llu candidates, counters of %u thread%s\n", order,
+        (unsigned long long)candidates, countedThreads, countedThreads==1 ? "" : "s");
+    fprintf(f, "%-10s %12s", "stage", "seconds");
+    if (countedThreads)
+        fprintf(f, " %16s %16s %6s %14s %14s %14s", "cycles", "instructions", "IPC",
+            "L1D miss/cand", "LLC miss/cand", "br miss/cand");
+    fprintf(f, "\n");
+    for (unsigned s=0; s<NUM_STAGES; s++) {
+        fprintf(f, "%-10s %12.6f", stageNames[s], std::chrono::duration<double>(stageTime[s]).count());
+        if (!countedThreads) {
+            fprintf(f, "\n");
+            continue;
+        }
+        const uint64_t* c = stageCounts[s];
+        if (countedEvents & cycles)
+            fprintf(f, " %16llu", (unsigned long long)c[PerfCounters::CYCLES]);
+        else
+            fprintf(f, " %16s", "-");
+        if (countedEvents & instrs)
+            fprintf(f, " %16llu", (unsigned long long)c[PerfCounters::INSTRUCTIONS]);
+        else
+            fprintf(f, " %16s", "-");
+        if ((countedEvents & cycles) && (countedEvents & instrs) && c[PerfCounters::CYCLES])
+            fprintf(f, " %6.2f", double(c[PerfCounters::INSTRUCTIONS])/c[PerfCounters::CYCLES]);
+        else
+            fprintf(f, " %6s", "-");
+        for (unsigned m=0; m<3; m++) {
+            if ((countedEvents & (1u << misses[m])) && candidates)
+                fprintf(f, " %14.3f", double(c[misses[m]])/candidates);
+            else
+                fprintf(f, " %14s", "-");
+        }
+        fprintf(f, "\n");
+    }
+}
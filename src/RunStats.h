@@ -0,0 +1,125 @@
+//=============================================================================
+//  A class for run statistics, rejection counters and progress reporting
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#ifndef RunStats_h
+#define RunStats_h
+#pragma once
+
+#include "PerfCounters.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <signal.h>
+#include <chrono>
+
+
+//-----------------------------------------------------------------------------
+class RunStats {
+//  counts what happens to every candidate of a run and, if enabled,
+//  the time spent per stage. Progress lines go to stderr, either
+//  periodically or when requested with SIGUSR1. With profile, the
+//  hardware counters of each thread are read at every lap as well, and
+//  added to the stage like the time; they are opened at the first lap,
+//  so in the thread that uses this instance.
+//-----------------------------------------------------------------------------
+  public:
+    enum Stage { ENUMERATE=0, SQUARING, FACTORS, OUTPUT, NUM_STAGES };
+
+    RunStats(bool timing, double progressSeconds=0, bool profile=false);
+
+    // order, size of the searched space and the number of ML polys expected
+    void SetSpace(unsigned order, double log2Candidates, double log2Expected);
+
+    // enumeration side: returns true when a progress line is due
+    bool Enumerated(void) {
+        candidates++;
+        if (--untilCheck && !progressRequested) return false;
+        return ProgressDue();
+    }
+    void Prefiltered(void) { prefiltered++; }
+    // for per-thread instances, which leave progress to the merged one
+    void AddCandidates(uint64_t n) { candidates += n; }
+
+    // tester side: result is the return value of TestPolynomial
+    void Tested(int result) {
+        if (result==0) accepted++;
+        else if (result>=-3) rejected[-result-1]++;
+    }
+    void Printed(unsigned long n=1) { printed += n; }
+
+    // accumulate the time since the last lap into the given stage
+    void Lap(Stage s) {
+        if (!timing) return;
+        if (profile) Count(s);
+        clock_type::time_point now = clock_type::now();
+        stageTime[s] += now-lapStart;
+        lapStart = now;
+    }
+
+    // moves the counters and times of a per-thread instance into this one
+    void Merge(RunStats& other);
+
+    bool Timing(void) const { return timing; }
+    bool Profiling(void) const { return profile; }
+    bool ProgressDue(void); // also for runs that only Merge()
+    void Progress(double fraction) const; // fraction<0 if unknown
+    int WriteJSON(const char* fileName) const; // "-" writes to stderr
+    void WriteProfile(FILE* f) const; // per stage, per candidate
+
+    static void InstallSignalHandler(void);
+    static void RequestProgress(void) { progressRequested = 1; }
+
+  private:
+    typedef std::chrono::steady_clock clock_type;
+
+    double Elapsed(void) const;
+    void Count(Stage s);
+
+    unsigned order;
+    bool timing;
+    double progressSeconds;
+    double log2Candidates;
+    double log2Expected;
+
+    uint64_t candidates;
+    uint64_t prefiltered;
+    uint64_t rejected[3];
+    uint64_t accepted;
+    uint64_t printed;
+
+    unsigned untilCheck;
+    clock_type::time_point startTime;
+    clock_type::time_point lastProgress;
+    clock_type::time_point lapStart;
+    clock_type::duration stageTime[NUM_STAGES];
+
+    bool profile;
+    bool countersTried;
+    unsigned countedThreads;
+    unsigned countedEvents; // bit e for PerfCounters::Event e
+    PerfCounters counters;
+    uint64_t stageCounts[NUM_STAGES][PerfCounters::NUM_EVENTS];
+
+    static volatile sig_atomic_t progressRequested;
+};
+
+#endif
@@ -0,0 +1,198 @@
+//=============================================================================
+//  Prints polynomials in sorted order when some are known ahead of time
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#ifndef SortedPolyWriter_h
+#define SortedPolyWriter_h
+#pragma once
+
+#include "LFSRPolynomial.h"
+
+#include <stdio.h>
+#include <vector>
+#include <algorithm>
+
+
+// default memory for pending polynomials, in MiB
+#define SORTED_DEFAULT_MEMORY 64
+
+
+template<typename poly_t=default_poly_t>
+//-----------------------------------------------------------------------------
+class SortedPolyWriter {
+//  With symmetric pairs, every asymmetric ML polynomial found also yields
+//  its dual, which is larger and is reached by the enumeration later.
+//  The duals are kept pending in a min-heap and printed once the
+//  enumeration has passed them. When the heap outgrows its memory, it is
+//  sorted and spilled as a run to a temporary file; the runs are merged
+//  with the heap on output, so memory stays bounded.
+//-----------------------------------------------------------------------------
+  public:
+    SortedPolyWriter(unsigned order, std::ostream& os, size_t memoryBytes);
+    ~SortedPolyWriter();
+
+    void Defer(const LFSRPolynomial<poly_t>& poly);   // print it later
+    // print pending polys below poly (all if poly is 0), up to maxCount
+    unsigned long Release(const LFSRPolynomial<poly_t>* poly, unsigned long maxCount);
+
+    size_t Pending(void) const { return pendingCount; }
+    unsigned Runs(void) const { return unsigned(runs.size()); }
+
+  protected:
+    struct Run {
+        FILE* file;
+        LFSRPolynomial<poly_t> head;
+        bool valid;
+        Run(unsigned order) : file(0), head(order), valid(false) {}
+    };
+    struct Later {
+        bool operator()(const LFSRPolynomial<poly_t>& a, const LFSRPolynomial<poly_t>& b) const
+            { return b < a; }
+    };
+
+    void Spill(void);
+    bool ReadHead(Run& run);
+
+    unsigned order;
+    std::ostream& os;
+    size_t maxHeap;
+    size_t pendingCount;
+    std::vector< LFSRPolynomial<poly_t> > heap;
+    std::vector<Run> runs;
+};
+
+
+//=============================================================================
+//  template implementation
+//=============================================================================
+
+template<typename poly_t>
+//-----------------------------------------------------------------------------
+SortedPolyWriter<poly_t>::SortedPolyWriter(unsigned ord, std::ostream& ostr, size_t memoryBytes)
+//-----------------------------------------------------------------------------
+:   order(ord), os(ostr), pendingCount(0)
+{
+    maxHeap = memoryBytes / sizeof(LFSRPolynomial<poly_t>);
+    if (maxHeap < 1024)
+        maxHeap = 1024;
+}
+
+template<typename poly_t>
+//-----------------------------------------------------------------------------
+SortedPolyWriter<poly_t>::~SortedPolyWriter()
+//-----------------------------------------------------------------------------
+{
+    for (unsigned r=0; r<runs.size(); r++) {
+        if (runs[r].file)
+            fclose(runs[r].file);
+    }
+}
+
+template<typename poly_t>
+//-----------------------------------------------------------------------------
+void SortedPolyWriter<poly_t>::Defer(const LFSRPolynomial<poly_t>& poly)
+//-----------------------------------------------------------------------------
+{
+    if (heap.size() >= maxHeap)
+        Spill();
+    heap.push_back(poly);
+    std::push_heap(heap.begin(), heap.end(), Later());
+    pendingCount++;
+}
+
+template<typename poly_t>
+//-----------------------------------------------------------------------------
+void SortedPolyWriter<poly_t>::Spill(void)
+//  writes the heap as a sorted run. If no temporary file can be opened,
+//  the heap just keeps growing.
+//-----------------------------------------------------------------------------
+{
+    FILE* file = tmpfile();
+    if (!file) {
+        std::cerr << "Warning: cannot open a temporary file, keeping "
+            << heap.size() << " pending polynomials in memory" << std::endl;
+        maxHeap *= 2;
+        return;
+    }
+    std::sort_heap(heap.begin(), heap.end(), Later()); // descending
+    for (size_t i=heap.size(); i; i--) {
+        const poly_t& p = heap[i-1];
+        if (fwrite(&p, sizeof(poly_t), 1, file) != 1) {
+            std::cerr << "Error writing a temporary file" << std::endl;
+            exit(-1);
+        }
+    }
+    heap.clear();
+    rewind(file);
+
+    runs.push_back(Run(order));
+    runs.back().file = file;
+    ReadHead(runs.back());
+}
+
+template<typename poly_t>
+//-----------------------------------------------------------------------------
+bool SortedPolyWriter<poly_t>::ReadHead(Run& run)
+//-----------------------------------------------------------------------------
+{
+    poly_t p;
+    run.valid = run.file && fread(&p, sizeof(poly_t), 1, run.file) == 1;
+    if (run.valid) {
+        run.head = LFSRPolynomial<poly_t>(order, p);
+    } else if (run.file) {
+        fclose(run.file);
+        run.file = 0;
+    }
+    return run.valid;
+}
+
+template<typename poly_t>
+//-----------------------------------------------------------------------------
+unsigned long SortedPolyWriter<poly_t>::Release(const LFSRPolynomial<poly_t>* poly, unsigned long maxCount)
+//  the runs are few, so their heads are simply scanned for the smallest
+//-----------------------------------------------------------------------------
+{
+    unsigned long n = 0;
+    while (n < maxCount && pendingCount) {
+        const LFSRPolynomial<poly_t>* next = heap.empty() ? 0 : &heap.front();
+        int fromRun = -1;
+        for (unsigned r=0; r<runs.size(); r++) {
+            if (runs[r].valid && (!next || runs[r].head < *next)) {
+                next = &runs[r].head;
+                fromRun = r;
+            }
+        }
+        if (poly && !(*next < *poly))
+            break;
+        os << *next << std::endl;
+        if (fromRun < 0) {
+            std::pop_heap(heap.begin(), heap.end(), Later());
+            heap.pop_back();
+        } else {
+            ReadHead(runs[fromRun]);
+        }
+        pendingCount--;
+        n++;
+    }
+    return n;
+}
+
+#endif
@@ -0,0 +1,176 @@
+//=============================================================================
+//  A class to test low-weight polynomials for maximality by reduction
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#ifndef SparsePolyTester_h
+#define SparsePolyTester_h
+#pragma once
+
+#include "MLPolyTester.h"
+#include "GF2Poly.h"
+
+
+// polynomials with more taps than this go to the dense matrix test
+#define SPARSE_DEFAULT_MAX_TAPS 16
+
+
+template<typename poly_t=default_poly_t, typename uintT=uintmax_t, typename fltT=long double>
+//-----------------------------------------------------------------------------
+class SparsePolyTester : public MLPolyTester<poly_t,uintT,fltT> {
+//  The polynomial with bit i set for the tap x**(i+1) (plus 1) is kept as
+//  its tap list. x**(2**i) and x**(shift) are computed modulo it, with
+//  squaring by bit spreading and reduction by shift-XOR per tap, which
+//  costs O(taps * order/64) word operations instead of a matrix product.
+//  Results and return values are the same as for MLPolyTester.
+//-----------------------------------------------------------------------------
+  public:
+    SparsePolyTester(unsigned order, unsigned verbosity=1, unsigned maxTaps=SPARSE_DEFAULT_MAX_TAPS);
+    SparsePolyTester(unsigned order, const std::vector<uintT>& primes, unsigned verbosity=1, unsigned maxTaps=SPARSE_DEFAULT_MAX_TAPS);
+
+    int TestPolynomial(const poly_t& poly); // sparse or dense, by tap count
+    int TestSparse(const poly_t& poly);     // always the sparse path
+
+    unsigned MaxTaps(void) const { return maxTaps; }
+    void SetMaxTaps(unsigned mxTaps) { maxTaps = mxTaps; }
+
+  protected:
+    int TestSparseStages(const poly_t& poly);
+
+    unsigned maxTaps;
+    std::vector<unsigned> taps;
+    GF2Modulus modulus;
+    GF2Words xPow, xOne, xVal;
+};
+
+
+//=============================================================================
+//  template implementation
+//=============================================================================
+
+template<typename poly_t, typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+SparsePolyTester<poly_t,uintT,fltT>::SparsePolyTester(unsigned ord, unsigned verbsty, unsigned mxTaps)
+//-----------------------------------------------------------------------------
+:   MLPolyTester<poly_t,uintT,fltT>(ord, verbsty), maxTaps(mxTaps), modulus(ord)
+{
+    modulus.One(xOne);
+    modulus.X(xVal);
+}
+
+template<typename poly_t, typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+SparsePolyTester<poly_t,uintT,fltT>::SparsePolyTester(unsigned ord, const std::vector<uintT>& primes, unsigned verbsty, unsigned mxTaps)
+//-----------------------------------------------------------------------------
+:   MLPolyTester<poly_t,uintT,fltT>(ord, primes, verbsty), maxTaps(mxTaps), modulus(ord)
+{
+    modulus.One(xOne);
+    modulus.X(xVal);
+}
+
+template<typename poly_t, typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+int SparsePolyTester<poly_t,uintT,fltT>::TestPolynomial(const poly_t& poly)
+//-----------------------------------------------------------------------------
+{
+    unsigned numTaps = 0;
+    for (unsigned i=0; i<this->order && numTaps<=maxTaps; i++) {
+        if (poly[i])
+            numTaps++;
+    }
+    if (numTaps > maxTaps)
+        return MLPolyTester<poly_t,uintT,fltT>::TestPolynomial(poly);
+    return TestSparse(poly);
+}
+
+template<typename poly_t, typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+int SparsePolyTester<poly_t,uintT,fltT>::TestSparse(const poly_t& poly)
+//-----------------------------------------------------------------------------
+{
+    // bit i is x**(i+1), the top one is x**order, and x**0 is implied
+    taps.clear();
+    taps.push_back(0);
+    for (unsigned i=0; i+1<this->order; i++) {
+        if (poly[i])
+            taps.push_back(i+1);
+    }
+    modulus.SetTaps(taps);
+
+    int result = TestSparseStages(poly);
+    if (this->stats)
+        this->stats->Tested(result);
+    return result;
+}
+
+template<typename poly_t, typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+int SparsePolyTester<poly_t,uintT,fltT>::TestSparseStages(const poly_t& poly)
+//  same return values as MLPolyTester::TestPolynomial
+//-----------------------------------------------------------------------------
+{
+    const unsigned order = this->order;
+    RunStats* stats = this->stats;
+
+    // x**(2**i) must not return to x before i==order, but must then
+    xPow = xVal;
+    for (unsigned i=0; i < order-1; i++) {
+        modulus.Square(xPow);
+        if (xPow == xVal) {
+            if (stats) stats->Lap(RunStats::SQUARING);
+            return -1;
+        }
+    }
+    modulus.Square(xPow);
+    if (stats) stats->Lap(RunStats::SQUARING);
+    if (xPow != xVal) return -2;
+
+    if (!this->subfields.empty()) {
+        int result = this->TestSubfields(poly);
+        if (stats) stats->Lap(RunStats::FACTORS);
+        return result;
+    }
+
+    // x**((2**order-1)/factor) must not be 1 for any prime factor
+    const std::vector<poly_t>& shifts = this->shifts;
+    if (shifts.size() > 1) {
+        for (unsigned k=0; k<shifts.size(); k++) {
+            unsigned bit = order;
+            while (bit && !shifts[k][bit-1])
+                bit--;
+            xPow = xOne;
+            for (; bit; bit--) {
+                modulus.Square(xPow);
+                if (shifts[k][bit-1])
+                    modulus.MulX(xPow);
+            }
+            if (xPow == xOne) {
+                if (stats) stats->Lap(RunStats::FACTORS);
+                return -3;
+            }
+        }
+    }
+    if (stats) stats->Lap(RunStats::FACTORS);
+
+    // passed all tests
+    return 0;
+}
+
+#endif
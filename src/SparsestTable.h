@@ -0,0 +1,91 @@
+//=============================================================================
+//  The minimum-weight ML polynomial of each order, for --sparsest
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+//  Written by make_sparsest_table.py, do not edit.
+//=============================================================================
+
+#ifndef SparsestTable_h
+#define SparsestTable_h
+#pragma once
+
+#include <stdint.h>
+
+// all orders from 2 to sparsestMaxOrder
+static const unsigned sparsestMaxOrder = 276;
+
+// per order, the exponents of the taps between x**order and 1 in
+// decreasing order, then zeros: x**order + x**a + x**b + x**c + 1.
+// For the first ML polynomial (in mlpolygen order) of the fewest taps.
+static const uint16_t sparsestTaps[277][3] = {
+    /*    0 */ {0,0,0}, {0,0,0}, {1,0,0}, {1,0,0}, {1,0,0}, {2,0,0}, {1,0,0}, {1,0,0},
+    /*    8 */ {4,3,2}, {4,0,0}, {3,0,0}, {2,0,0}, {6,4,1}, {4,3,1}, {5,3,1}, {1,0,0},
+    /*   16 */ {5,3,2}, {3,0,0}, {7,0,0}, {5,2,1}, {3,0,0}, {2,0,0}, {1,0,0}, {5,0,0},
+    /*   24 */ {4,3,1}, {3,0,0}, {6,2,1}, {5,2,1}, {3,0,0}, {2,0,0}, {6,4,1}, {3,0,0},
+    /*   32 */ {7,6,2}, {13,0,0}, {8,4,3}, {2,0,0}, {11,0,0}, {6,4,1}, {6,5,1}, {4,0,0},
+    /*   40 */ {5,4,3}, {3,0,0}, {7,4,3}, {6,4,3}, {6,5,2}, {4,3,1}, {8,7,6}, {5,0,0},
+    /*   48 */ {9,7,4}, {9,0,0}, {4,3,2}, {6,3,1}, {3,0,0}, {6,2,1}, {8,6,3}, {24,0,0},
+    /*   56 */ {7,4,2}, {7,0,0}, {19,0,0}, {7,4,2}, {1,0,0}, {5,2,1}, {6,5,3}, {1,0,0},
+    /*   64 */ {4,3,1}, {18,0,0}, {9,8,6}, {5,2,1}, {9,0,0}, {6,5,2}, {5,3,1}, {6,0,0},
+    /*   72 */ {10,9,3}, {25,0,0}, {7,4,3}, {6,3,1}, {5,4,2}, {6,5,2}, {7,2,1}, {9,0,0},
+    /*   80 */ {9,4,2}, {4,0,0}, {9,6,4}, {7,4,2}, {13,0,0}, {8,2,1}, {6,5,2}, {13,0,0},
+    /*   88 */ {11,9,8}, {38,0,0}, {5,3,2}, {8,5,1}, {6,5,2}, {2,0,0}, {21,0,0}, {11,0,0},
+    /*   96 */ {10,9,6}, {6,0,0}, {11,0,0}, {7,5,4}, {37,0,0}, {7,6,1}, {6,5,3}, {9,0,0},
+    /*  104 */ {11,10,1}, {16,0,0}, {15,0,0}, {9,7,4}, {31,0,0}, {5,4,2}, {6,4,1}, {10,0,0},
+    /*  112 */ {11,6,4}, {9,0,0}, {11,2,1}, {8,7,5}, {6,5,2}, {5,2,1}, {33,0,0}, {8,0,0},
+    /*  120 */ {9,6,2}, {18,0,0}, {6,2,1}, {2,0,0}, {37,0,0}, {7,6,5}, {7,4,2}, {1,0,0},
+    /*  128 */ {7,2,1}, {5,0,0}, {3,0,0}, {8,3,2}, {29,0,0}, {9,8,2}, {57,0,0}, {11,0,0},
+    /*  136 */ {8,3,2}, {21,0,0}, {8,7,1}, {8,5,3}, {29,0,0}, {13,6,1}, {21,0,0}, {5,3,2},
+    /*  144 */ {7,4,2}, {52,0,0}, {5,3,2}, {11,4,2}, {27,0,0}, {10,9,7}, {53,0,0}, {3,0,0},
+    /*  152 */ {6,3,2}, {1,0,0}, {9,5,1}, {7,5,4}, {9,5,3}, {6,5,2}, {8,6,5}, {31,0,0},
+    /*  160 */ {5,3,2}, {18,0,0}, {8,7,4}, {7,6,3}, {12,6,5}, {9,8,3}, {10,3,2}, {6,0,0},
+    /*  168 */ {16,9,6}, {34,0,0}, {23,0,0}, {6,5,2}, {7,0,0}, {8,5,2}, {13,0,0}, {6,0,0},
+    /*  176 */ {12,11,9}, {8,0,0}, {87,0,0}, {4,2,1}, {12,10,7}, {7,6,1}, {8,6,1}, {56,0,0},
+    /*  184 */ {9,8,7}, {24,0,0}, {9,8,6}, {7,6,5}, {6,5,2}, {6,5,2}, {13,6,2}, {9,0,0},
+    /*  192 */ {15,11,5}, {15,0,0}, {87,0,0}, {8,3,2}, {11,9,2}, {9,4,2}, {65,0,0}, {34,0,0},
+    /*  200 */ {5,3,2}, {14,0,0}, {55,0,0}, {8,7,1}, {10,4,3}, {9,5,2}, {10,9,5}, {43,0,0},
+    /*  208 */ {9,3,1}, {6,0,0}, {12,4,3}, {11,10,8}, {105,0,0}, {6,5,2}, {5,3,1}, {23,0,0},
+    /*  216 */ {7,3,1}, {45,0,0}, {11,0,0}, {8,4,1}, {12,10,9}, {8,6,2}, {8,5,2}, {33,0,0},
+    /*  224 */ {12,7,2}, {32,0,0}, {10,7,3}, {10,9,4}, {12,11,2}, {10,4,1}, {8,7,6}, {26,0,0},
+    /*  232 */ {11,9,4}, {74,0,0}, {31,0,0}, {9,6,1}, {5,0,0}, {7,4,1}, {5,2,1}, {36,0,0},
+    /*  240 */ {8,5,3}, {70,0,0}, {11,6,1}, {8,5,1}, {9,4,1}, {6,4,1}, {11,2,1}, {82,0,0},
+    /*  248 */ {15,14,10}, {86,0,0}, {103,0,0}, {7,4,2}, {67,0,0}, {7,3,2}, {7,2,1}, {52,0,0},
+    /*  256 */ {10,5,2}, {12,0,0}, {83,0,0}, {10,6,2}, {10,8,7}, {7,6,4}, {9,8,4}, {93,0,0},
+    /*  264 */ {10,9,1}, {42,0,0}, {47,0,0}, {8,6,3}, {25,0,0}, {7,6,1}, {53,0,0}, {58,0,0},
+    /*  272 */ {9,6,2}, {23,0,0}, {67,0,0}, {11,10,9}, {6,3,1},
+};
+
+
+//-----------------------------------------------------------------------------
+inline unsigned SparsestTaps(unsigned order, unsigned taps[3])
+//  the number of exponents written to taps, 0 if order is not in the table
+//-----------------------------------------------------------------------------
+{
+    if (order > sparsestMaxOrder)
+        return 0;
+    unsigned num = 0;
+    while (num < 3 && sparsestTaps[order][num]) {
+        taps[num] = sparsestTaps[order][num];
+        num++;
+    }
+    return num;
+}
+
+#endif
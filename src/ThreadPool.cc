@@ -0,0 +1,101 @@
+//=============================================================================
+//  A small pool of worker threads for parallel loops
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "ThreadPool.h"
+
+
+//-----------------------------------------------------------------------------
+ThreadPool::ThreadPool(unsigned numThreads)
+//-----------------------------------------------------------------------------
+:   job(0), jobCount(0), nextIndex(0), busy(0), generation(0), quit(false)
+{
+    if (!numThreads)
+        numThreads = std::thread::hardware_concurrency();
+    for (unsigned t=1; t<numThreads; t++)
+        workers.push_back(std::thread(&ThreadPool::WorkerLoop, this, t));
+}
+
+//-----------------------------------------------------------------------------
+ThreadPool::~ThreadPool()
+//-----------------------------------------------------------------------------
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+    wake.notify_all();
+    for (unsigned t=0; t<workers.size(); t++)
+        workers[t].join();
+}
+
+//-----------------------------------------------------------------------------
+void ThreadPool::RunIndices(unsigned thread)
+//-----------------------------------------------------------------------------
+{
+    unsigned index;
+    while ((index = nextIndex++) < jobCount)
+        (*job)(index, thread);
+}
+
+//-----------------------------------------------------------------------------
+void ThreadPool::WorkerLoop(unsigned thread)
+//-----------------------------------------------------------------------------
+{
+    unsigned long seen = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (1) {
+        wake.wait(lock, [&]{ return quit || generation!=seen; });
+        if (quit)
+            return;
+        seen = generation;
+        lock.unlock();
+        RunIndices(thread);
+        lock.lock();
+        if (--busy == 0)
+            done.notify_all();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void ThreadPool::ParallelFor(unsigned count, const std::function<void(unsigned,unsigned)>& func)
+//-----------------------------------------------------------------------------
+{
+    if (workers.empty() || count<2) {
+        for (unsigned index=0; index<count; index++)
+            func(index, 0);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &func;
+        jobCount = count;
+        nextIndex = 0;
+        busy = unsigned(workers.size());
+        generation++;
+    }
+    wake.notify_all();
+    RunIndices(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&]{ return busy==0; });
+    job = 0;
+}
@@ -0,0 +1,70 @@
+//=============================================================================
+//  A small pool of worker threads for parallel loops
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#ifndef ThreadPool_h
+#define ThreadPool_h
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+//-----------------------------------------------------------------------------
+class ThreadPool {
+//  ParallelFor() hands out the indices of a loop to the pool's threads
+//  and to the calling thread, and returns when all have been processed.
+//  A pool of size 1 has no extra threads and runs the loop in the caller.
+//-----------------------------------------------------------------------------
+  public:
+    ThreadPool(unsigned numThreads=0); // 0 for one per hardware thread
+    ~ThreadPool();
+
+    unsigned Size(void) const { return unsigned(workers.size())+1; }
+
+    // func(index, thread) for index in [0,count), thread in [0,Size())
+    void ParallelFor(unsigned count, const std::function<void(unsigned,unsigned)>& func);
+
+  private:
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+
+    void WorkerLoop(unsigned thread);
+    void RunIndices(unsigned thread);
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    const std::function<void(unsigned,unsigned)>* job;
+    unsigned jobCount;
+    std::atomic<unsigned> nextIndex;
+    unsigned busy;
+    unsigned long generation;
+    bool quit;
+};
+
+#endif
@@ -0,0 +1,151 @@
+//=============================================================================
+//  The tester settings found by --tune, per CPU model and order
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "TuneCache.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+
+//-----------------------------------------------------------------------------
+TuneCache::TuneCache(const char* fname)
+//-----------------------------------------------------------------------------
+:   fileName(fname ? fname : FileName()), model(CPUModel())
+{
+}
+
+//-----------------------------------------------------------------------------
+std::string TuneCache::FileName(void)
+//-----------------------------------------------------------------------------
+{
+    const char* env = getenv("MLPOLYGEN_TUNE");
+    if (env && env[0])
+        return env;
+    env = getenv("HOME");
+    if (!env || !env[0])
+        return TUNE_CACHE_FILE;
+    return std::string(env) + "/" + TUNE_CACHE_FILE;
+}
+
+//-----------------------------------------------------------------------------
+std::string TuneCache::CPUModel(void)
+//  "model name" of the first CPU, without the tabs and spaces around it
+//-----------------------------------------------------------------------------
+{
+    std::ifstream file("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.compare(0, 10, "model name"))
+            continue;
+        std::string::size_type colon = line.find(':');
+        if (colon == std::string::npos)
+            continue;
+        std::string::size_type begin = line.find_first_not_of(" \t", colon+1);
+        std::string::size_type end = line.find_last_not_of(" \t\r");
+        if (begin == std::string::npos)
+            break;
+        std::string name = line.substr(begin, end+1-begin);
+        for (unsigned i=0; i<name.size(); i++) {
+            if (name[i] == '\t')
+                name[i] = ' ';
+        }
+        return name;
+    }
+    return "unknown";
+}
+
+//-----------------------------------------------------------------------------
+int TuneCache::Load(void)
+//-----------------------------------------------------------------------------
+{
+    std::ifstream file(fileName.c_str());
+    if (!file)
+        return -1;
+    int numLines = 0;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#')
+            continue;
+        std::string::size_type tab = line.find('\t');
+        if (tab == std::string::npos)
+            continue;
+        std::istringstream fields(line.substr(tab+1));
+        unsigned order;
+        TuneSettings settings;
+        if (!(fields >> order >> settings.sparseTaps))
+            continue;
+        if (!(fields >> settings.blockSize))
+            settings.blockSize = 0;
+        entries[std::make_pair(line.substr(0, tab), order)] = settings;
+        numLines++;
+    }
+    return numLines;
+}
+
+//-----------------------------------------------------------------------------
+int TuneCache::Save(void) const
+//  to a temporary file first, so that a run reading it sees all or nothing
+//-----------------------------------------------------------------------------
+{
+    const std::string tmpName = fileName + ".tmp";
+    {
+        std::ofstream file(tmpName.c_str());
+        file << "# mlpolygen --tune: model, order, sparse-taps, block-size\n";
+        for (Entries::const_iterator it=entries.begin(); it!=entries.end(); ++it) {
+            file << it->first.first << "\t" << it->first.second << "\t"
+                << it->second.sparseTaps << "\t" << it->second.blockSize << "\n";
+        }
+        file.flush();
+        if (!file) {
+            std::cerr << "Error writing " << tmpName << std::endl;
+            remove(tmpName.c_str());
+            return -1;
+        }
+    }
+    if (rename(tmpName.c_str(), fileName.c_str())) {
+        std::cerr << "Error renaming " << tmpName << " to " << fileName << std::endl;
+        remove(tmpName.c_str());
+        return -1;
+    }
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+bool TuneCache::Lookup(unsigned order, TuneSettings& settings) const
+//-----------------------------------------------------------------------------
+{
+    Entries::const_iterator it = entries.find(std::make_pair(model, order));
+    if (it == entries.end())
+        return false;
+    settings = it->second;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void TuneCache::Store(unsigned order, const TuneSettings& settings)
+//-----------------------------------------------------------------------------
+{
+    entries[std::make_pair(model, order)] = settings;
+}
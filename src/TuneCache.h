@@ -0,0 +1,74 @@
+//=============================================================================
+//  The tester settings found by --tune, per CPU model and order
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#ifndef TuneCache_h
+#define TuneCache_h
+#pragma once
+
+#include <map>
+#include <string>
+#include <utility>
+
+// the file in $HOME, unless MLPOLYGEN_TUNE names another one
+#define TUNE_CACHE_FILE ".mlpolygen_tune"
+
+
+//-----------------------------------------------------------------------------
+struct TuneSettings {
+//-----------------------------------------------------------------------------
+    unsigned sparseTaps;    // as for '--sparse-taps'
+    unsigned blockSize;     // of BatchPolyTester, 0 for the default
+};
+
+
+//-----------------------------------------------------------------------------
+class TuneCache {
+//  A text file with a line per CPU model and order, tab separated:
+//      model   order   sparse-taps   block-size
+//  The model is that of /proc/cpuinfo (or "unknown"), so a home directory
+//  shared by different hosts keeps the settings of each. Lines of other
+//  models are kept as they are when the file is written again. A missing
+//  block size (from older files) is 0.
+//-----------------------------------------------------------------------------
+  public:
+    TuneCache(const char* fileName=0);  // default: FileName()
+
+    static std::string FileName(void);
+    static std::string CPUModel(void);
+
+    int Load(void);     // the number of lines read, -1 if there is no file
+    int Save(void) const;
+
+    bool Lookup(unsigned order, TuneSettings& settings) const;
+    void Store(unsigned order, const TuneSettings& settings);
+
+    const std::string& Model(void) const { return model; }
+
+  private:
+    typedef std::map< std::pair<std::string,unsigned>, TuneSettings > Entries;
+
+    std::string fileName;
+    std::string model;
+    Entries entries;
+};
+
+#endif
@@ -0,0 +1,537 @@
+//=============================================================================
+//  Leased ranges of candidates, for searches over many processes
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "WorkQueue.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#ifndef _WIN32
+#include <netdb.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#endif
+
+// a worker that stops sending in the middle of a request is dropped
+#define RECEIVE_TIMEOUT_SECONDS 60
+
+// how long a worker waits before asking again, when all ranges are leased
+#define WAIT_SECONDS 2
+
+static volatile sig_atomic_t stopRequested = 0;
+
+
+//-----------------------------------------------------------------------------
+WorkCoordinator::WorkCoordinator(unsigned ordr, unsigned bts, bool pairs,
+    const char* drctry, double lease, int verbsty)
+//-----------------------------------------------------------------------------
+:   order(ordr), bits(bts), inPairs(pairs), dir(drctry ? drctry : "."),
+    leaseSeconds(lease), verbosity(verbsty),
+    done(size_t(1)<<bts, 0), expires(size_t(1)<<bts), numDone(0), numPolys(0),
+    connections(0)
+{
+}
+
+//-----------------------------------------------------------------------------
+unsigned WorkCoordinator::DefaultBits(unsigned order)
+//  as test/mlpolyN.py, but with smaller ranges: they are handed out one
+//  at a time, so there is no need for them to be even
+//-----------------------------------------------------------------------------
+{
+    if (order <= 20)
+        return 0;
+    return order-20 < 16 ? order-20 : 16;
+}
+
+//-----------------------------------------------------------------------------
+std::string WorkCoordinator::FileName(unsigned long id) const
+//  the ids as fixed hex digits, so the files of the ranges list in order
+//-----------------------------------------------------------------------------
+{
+    std::ostringstream os;
+    os << dir << "/mlpoly" << order;
+    if (id != ~0ul)
+        os << "-" << std::hex << std::setfill('0') << std::setw((bits+3)/4) << id << ".txt";
+    else
+        os << ".done";
+    return os.str();
+}
+
+//-----------------------------------------------------------------------------
+std::string WorkCoordinator::RangeHex(unsigned long id, bool last) const
+//  the top bit, the bits of the range id, then all zeros or all ones
+//-----------------------------------------------------------------------------
+{
+    static const char digits[] = "0123456789abcdef";
+    std::string hex;
+    unsigned nibble = 0;
+    for (int i=order-1; i>=0; i--) {
+        const unsigned below = order-1-i; // bits below the top one so far
+        unsigned bit = 1;
+        if (i != int(order)-1)
+            bit = below <= bits ? (id >> (bits-below)) & 1 : last;
+        nibble = (nibble << 1) | bit;
+        if (i % 4 == 0) {
+            hex += digits[nibble];
+            nibble = 0;
+        }
+    }
+    return hex;
+}
+
+//-----------------------------------------------------------------------------
+long WorkCoordinator::Restore(void)
+//  the first line of the done file holds the order, bits and pairs, as
+//  the ids mean nothing with others
+//-----------------------------------------------------------------------------
+{
+    std::ostringstream header;
+    header << "# order " << order << " bits " << bits << " pairs " << inPairs;
+    const std::string doneFile = FileName(~0ul);
+    std::ifstream is(doneFile.c_str());
+    if (!is) {
+        std::ofstream os(doneFile.c_str());
+        os << header.str() << std::endl;
+        if (!os) {
+            std::cerr << "Error writing " << doneFile << std::endl;
+            return -1;
+        }
+        return 0;
+    }
+    std::string line;
+    std::getline(is, line);
+    if (line != header.str()) {
+        std::cerr << "Error: " << doneFile << " is for another search (" << line << ")" << std::endl;
+        return -1;
+    }
+    unsigned long id;
+    while (is >> std::hex >> id) {
+        if (id < done.size() && !done[id]) {
+            done[id] = 1;
+            numDone++;
+        }
+    }
+    return long(numDone);
+}
+
+//-----------------------------------------------------------------------------
+std::string WorkCoordinator::Lease(void)
+//  the first range that is neither done nor leased
+//-----------------------------------------------------------------------------
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (numDone == done.size())
+        return "done";
+    const Clock::time_point now = Clock::now();
+    for (unsigned long id=0; id<done.size(); id++) {
+        if (done[id] || now < expires[id])
+            continue;
+        const bool again = expires[id] != Clock::time_point();
+        expires[id] = now + std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(leaseSeconds));
+        if (1<=verbosity)
+            std::cerr << (again ? "leasing again " : "leasing ") << std::hex << id << std::dec << std::endl;
+        std::ostringstream reply;
+        reply << "range " << id << " " << order << " " << RangeHex(id, false)
+            << " " << RangeHex(id, true) << " " << inPairs;
+        return reply.str();
+    }
+    std::ostringstream reply;
+    reply << "wait " << WAIT_SECONDS;
+    return reply.str();
+}
+
+//-----------------------------------------------------------------------------
+std::string WorkCoordinator::Complete(unsigned long id, const std::vector<std::string>& polys)
+//  the file is written whole under another name first, so a range is
+//  never done with part of its results
+//-----------------------------------------------------------------------------
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (id >= done.size())
+        return "err no such range";
+    if (done[id])
+        return "ok"; // its lease expired, and another worker was faster
+
+    const std::string name = FileName(id);
+    const std::string temp = name + ".tmp";
+    {
+        std::ofstream os(temp.c_str());
+        for (unsigned i=0; i<polys.size(); i++)
+            os << polys[i] << "\n";
+        os.flush();
+        if (!os) {
+            std::cerr << "Error writing " << temp << std::endl;
+            return "err cannot write the results";
+        }
+    }
+    if (rename(temp.c_str(), name.c_str())) {
+        std::cerr << "Error renaming " << temp << ": " << strerror(errno) << std::endl;
+        return "err cannot write the results";
+    }
+    std::ofstream doneFile(FileName(~0ul).c_str(), std::ios::app);
+    doneFile << std::hex << id << std::endl;
+    if (!doneFile) {
+        std::cerr << "Error writing " << FileName(~0ul) << std::endl;
+        return "err cannot write the results";
+    }
+
+    done[id] = 1;
+    numDone++;
+    numPolys += polys.size();
+    if (1<=verbosity) {
+        std::cerr << "range " << std::hex << id << std::dec << ": " << polys.size()
+            << " polynomials, " << numDone << " of " << done.size() << " ranges done" << std::endl;
+    }
+    return "ok";
+}
+
+#ifndef _WIN32
+
+//-----------------------------------------------------------------------------
+static void StopHandler(int)
+//-----------------------------------------------------------------------------
+{
+    stopRequested = 1;
+}
+
+//-----------------------------------------------------------------------------
+static bool SendAll(int fd, const std::string& data)
+//-----------------------------------------------------------------------------
+{
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data()+sent, data.size()-sent, 0);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        sent += n;
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+static bool ReceiveLine(int fd, std::string& buffer, std::string& line)
+//  false when the connection closes or times out first
+//-----------------------------------------------------------------------------
+{
+    size_t eol;
+    while ((eol = buffer.find('\n')) == std::string::npos) {
+        char chunk[4096];
+        ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        buffer.append(chunk, n);
+    }
+    line = buffer.substr(0, eol);
+    buffer.erase(0, eol+1);
+    if (line.size() && line[line.size()-1]=='\r')
+        line.erase(line.size()-1);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+static int OpenSocket(const char* address, bool listening)
+//  host:port is TCP, anything else a Unix socket path
+//-----------------------------------------------------------------------------
+{
+    const char* colon = strrchr(address, ':');
+    int fd = -1;
+    if (!colon) {
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (strlen(address) >= sizeof(addr.sun_path)) {
+            std::cerr << "Error: socket path too long: " << address << std::endl;
+            return -1;
+        }
+        strcpy(addr.sun_path, address);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0)
+            return -1;
+        if (listening)
+            unlink(address);
+        const int result = listening ?
+            bind(fd, (struct sockaddr*)&addr, sizeof(addr)) :
+            connect(fd, (struct sockaddr*)&addr, sizeof(addr));
+        if (result < 0) {
+            close(fd);
+            return -1;
+        }
+    } else {
+        const std::string host(address, colon);
+        struct addrinfo hints, *found = 0;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = listening ? AI_PASSIVE : 0;
+        if (getaddrinfo(host.size() ? host.c_str() : 0, colon+1, &hints, &found))
+            return -1;
+        for (struct addrinfo* ai=found; ai && fd<0; ai=ai->ai_next) {
+            fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (fd < 0)
+                continue;
+            int on = 1;
+            if (listening)
+                setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+            if ((listening ? bind(fd, ai->ai_addr, ai->ai_addrlen) :
+                    connect(fd, ai->ai_addr, ai->ai_addrlen)) < 0) {
+                close(fd);
+                fd = -1;
+            }
+        }
+        freeaddrinfo(found);
+    }
+    if (fd >= 0 && listening && listen(fd, 64) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+//-----------------------------------------------------------------------------
+void WorkCoordinator::Connection(int fd)
+//-----------------------------------------------------------------------------
+{
+    struct timeval timeout = { RECEIVE_TIMEOUT_SECONDS, 0 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    std::string buffer, line, reply;
+    if (ReceiveLine(fd, buffer, line)) {
+        std::istringstream is(line);
+        std::string cmd;
+        unsigned long id = 0, count = 0;
+        is >> cmd;
+        if (2<=verbosity)
+            std::cerr << "request: " << line << std::endl;
+        if (cmd == "lease") {
+            reply = Lease();
+        } else if (cmd == "result" && (is >> id >> count)) {
+            std::vector<std::string> polys;
+            while (polys.size() < count && ReceiveLine(fd, buffer, line))
+                polys.push_back(line);
+            if (polys.size() == count)
+                reply = Complete(id, polys);
+        } else {
+            reply = "err unknown request '" + line + "'";
+        }
+        if (reply.size())
+            SendAll(fd, reply + "\n");
+    }
+    close(fd);
+    connections--;
+}
+
+//-----------------------------------------------------------------------------
+int WorkCoordinator::Serve(const char* address)
+//-----------------------------------------------------------------------------
+{
+    if (bits >= order) {
+        std::cerr << "Error: at most " << order-1 << " bits of ranges for order " << order << std::endl;
+        return -1;
+    }
+    int listenFd = OpenSocket(address, true);
+    if (listenFd < 0) {
+        std::cerr << "Error listening on " << address << ": " << strerror(errno) << std::endl;
+        return -1;
+    }
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = StopHandler;
+    sigaction(SIGINT, &sa, 0);
+    sigaction(SIGTERM, &sa, 0);
+    signal(SIGPIPE, SIG_IGN);
+
+    if (1<=verbosity) {
+        std::cerr << "coordinating " << done.size() << " ranges of order " << order
+            << " on " << address << ", " << numDone << " done before" << std::endl;
+    }
+    // the done count is checked between connections, once a second at least
+    bool finished = false;
+    while (!stopRequested && !finished) {
+        struct pollfd pfd = { listenFd, POLLIN, 0 };
+        const int ready = poll(&pfd, 1, 1000);
+        if (ready > 0) {
+            int fd = accept(listenFd, 0, 0);
+            if (fd < 0 && errno != EINTR) {
+                std::cerr << "Error accepting: " << strerror(errno) << std::endl;
+                break;
+            }
+            if (fd >= 0) {
+                connections++;
+                std::thread(&WorkCoordinator::Connection, this, fd).detach();
+            }
+        } else if (ready < 0 && errno != EINTR) {
+            std::cerr << "Error polling: " << strerror(errno) << std::endl;
+            break;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        finished = numDone == done.size();
+    }
+    close(listenFd);
+    if (!strchr(address, ':'))
+        unlink(address);
+
+    // let the open connections finish their current request
+    for (unsigned wait=0; connections && wait<50; wait++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::cerr << numDone << " of " << done.size() << " ranges done, "
+        << numPolys << " polynomials in this run" << std::endl;
+    if (finished)
+        return 0;
+    return stopRequested ? 1 : -1;
+}
+
+
+//-----------------------------------------------------------------------------
+WorkClient::WorkClient(const char* addr)
+//-----------------------------------------------------------------------------
+:   address(addr), connected(false)
+{
+    signal(SIGPIPE, SIG_IGN);
+}
+
+//-----------------------------------------------------------------------------
+int WorkClient::Request(const std::string& request, std::string& reply)
+//  1 when the coordinator cannot be reached
+//-----------------------------------------------------------------------------
+{
+    int fd = OpenSocket(address.c_str(), false);
+    if (fd < 0)
+        return 1;
+    std::string buffer;
+    const bool ok = SendAll(fd, request) && ReceiveLine(fd, buffer, reply);
+    close(fd);
+    connected = true;
+    if (!ok) {
+        std::cerr << "Error: no reply from " << address << std::endl;
+        return -1;
+    }
+    if (reply.compare(0, 4, "err ") == 0) {
+        std::cerr << "Error from " << address << ": " << reply.substr(4) << std::endl;
+        return -1;
+    }
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+int WorkClient::Lease(WorkRange& range)
+//-----------------------------------------------------------------------------
+{
+    while (1) {
+        const bool wasConnected = connected;
+        std::string reply;
+        int result = Request("lease\n", reply);
+        if (result > 0) {
+            if (wasConnected)
+                return 0;
+            std::cerr << "Error connecting to " << address << ": " << strerror(errno) << std::endl;
+            return -1;
+        }
+        if (result < 0)
+            return -1;
+
+        std::istringstream is(reply);
+        std::string cmd;
+        is >> cmd;
+        if (cmd == "done")
+            return 0;
+        if (cmd == "wait") {
+            unsigned seconds = WAIT_SECONDS;
+            is >> seconds;
+            std::this_thread::sleep_for(std::chrono::seconds(seconds));
+            continue;
+        }
+        if (cmd == "range" && (is >> range.id >> range.order >> range.start >> range.end >> range.inPairs))
+            return 1;
+        std::cerr << "Error: unexpected reply from " << address << ": " << reply << std::endl;
+        return -1;
+    }
+}
+
+//-----------------------------------------------------------------------------
+int WorkClient::Complete(const WorkRange& range, const std::vector<std::string>& polys)
+//-----------------------------------------------------------------------------
+{
+    std::ostringstream request;
+    request << "result " << range.id << " " << polys.size() << "\n";
+    for (unsigned i=0; i<polys.size(); i++)
+        request << polys[i] << "\n";
+    std::string reply;
+    int result = Request(request.str(), reply);
+    if (result > 0) {
+        std::cerr << "Error connecting to " << address << ": " << strerror(errno) << std::endl;
+        return -1;
+    }
+    return result;
+}
+
+#else
+
+//-----------------------------------------------------------------------------
+int WorkCoordinator::Serve(const char* address)
+//-----------------------------------------------------------------------------
+{
+    std::cerr << "Error: --coordinator is only supported with POSIX sockets" << std::endl;
+    return -1;
+}
+
+//-----------------------------------------------------------------------------
+WorkClient::WorkClient(const char* addr)
+//-----------------------------------------------------------------------------
+:   address(addr), connected(false)
+{
+}
+
+//-----------------------------------------------------------------------------
+int WorkClient::Lease(WorkRange& range)
+//-----------------------------------------------------------------------------
+{
+    std::cerr << "Error: --worker is only supported with POSIX sockets" << std::endl;
+    return -1;
+}
+
+//-----------------------------------------------------------------------------
+int WorkClient::Complete(const WorkRange& range, const std::vector<std::string>& polys)
+//-----------------------------------------------------------------------------
+{
+    return -1;
+}
+
+#endif
@@ -0,0 +1,131 @@
+//=============================================================================
+//  Leased ranges of candidates, for searches over many processes
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#ifndef WorkQueue_h
+#define WorkQueue_h
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// a range not completed in this time is leased again
+#define WORK_DEFAULT_LEASE_SECONDS 600
+
+// at most 2**this many ranges
+#define WORK_MAX_BITS 24
+
+
+//-----------------------------------------------------------------------------
+struct WorkRange {
+//  the candidates from start to end (hex, in mlpolygen notation)
+//-----------------------------------------------------------------------------
+    unsigned long id;
+    unsigned order;
+    std::string start, end;
+    bool inPairs;
+};
+
+
+//-----------------------------------------------------------------------------
+class WorkCoordinator {
+//  Splits the candidates of one order into 2**bits ranges and leases them
+//  to workers. An address with a colon is TCP "host:port" (an empty host
+//  listens on all interfaces), anything else a Unix socket path. Each
+//  connection carries one request line:
+//
+//      lease               ->  range ID ORDER START END PAIRS (0 or 1),
+//                              or wait SECONDS, or done
+//      result ID COUNT     ->  then COUNT lines of polynomials; ok
+//
+//  Errors are replied as "err MESSAGE". A range that is not completed
+//  within the lease time is given out again, and whichever result comes
+//  first is kept. The results of range ID are written to
+//  DIR/mlpolyN-ID.txt, and then ID is appended to DIR/mlpolyN.done, so
+//  a restarted coordinator leases only the ranges that remain.
+//-----------------------------------------------------------------------------
+  public:
+    WorkCoordinator(unsigned order, unsigned bits, bool inPairs, const char* dir,
+        double leaseSeconds, int verbosity=0);
+
+    // the ranges already in the done file, -1 if it cannot be read
+    long Restore(void);
+
+    // returns when all ranges are done (0), on SIGINT or SIGTERM (1)
+    // or on errors (-1)
+    int Serve(const char* address);
+
+    // the default bits, about a million candidates per range
+    static unsigned DefaultBits(unsigned order);
+
+  private:
+    WorkCoordinator(const WorkCoordinator&);
+    WorkCoordinator& operator=(const WorkCoordinator&);
+
+    typedef std::chrono::steady_clock Clock;
+
+    void Connection(int fd);
+    std::string Lease(void);
+    std::string Complete(unsigned long id, const std::vector<std::string>& polys);
+    std::string RangeHex(unsigned long id, bool last) const;
+    std::string FileName(unsigned long id) const;
+
+    unsigned order, bits;
+    bool inPairs;
+    std::string dir;
+    double leaseSeconds;
+    int verbosity;
+
+    std::mutex mutex;
+    std::vector<char> done;
+    std::vector<Clock::time_point> expires; // leased while in the future
+    unsigned long numDone;
+    uint64_t numPolys;
+    std::atomic<unsigned> connections;
+};
+
+
+//-----------------------------------------------------------------------------
+class WorkClient {
+//  a worker's side of the coordinator requests above
+//-----------------------------------------------------------------------------
+  public:
+    WorkClient(const char* address);
+
+    // 1 with a range, 0 when the search is done, -1 on errors; waits
+    // out the "wait" replies. A coordinator that has gone away after
+    // the first lease is done, too.
+    int Lease(WorkRange& range);
+
+    int Complete(const WorkRange& range, const std::vector<std::string>& polys);
+
+  private:
+    int Request(const std::string& request, std::string& reply);
+
+    std::string address;
+    bool connected;
+};
+
+#endif
@@ -0,0 +1,605 @@
+//=============================================================================
+//  C interface of libmlpolygen
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "mlpolygen.h"
+#include "MLPolyTypes.h"
+#include "MLPolyTester.h"
+#include "MLPolyRange.h"
+#include "FactorCache.h"
+#include "ThreadPool.h"
+#include "LFSRSequence.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef MLPOLYGEN_VERSION
+#define MLPOLYGEN_VERSION "UNKNOWN"
+#endif
+
+
+//-----------------------------------------------------------------------------
+struct mlpg_cache {
+//  a NULL cache stands for FactorCache::Shared(), which mlpolygen itself
+//  uses too, so '--factor-cache' and mlpg_cache_load(NULL) fill the same
+//-----------------------------------------------------------------------------
+    FactorCache<reg_uint_t,reg_float_t> reg;
+#ifdef USING_GMP
+    FactorCache<big_uint_t,big_float_t> big;
+#endif
+};
+
+inline FactorCache<reg_uint_t,reg_float_t>& CacheFor(mlpg_cache* c, reg_uint_t*)
+    { return c ? c->reg : FactorCache<reg_uint_t,reg_float_t>::Shared(); }
+#ifdef USING_GMP
+inline FactorCache<big_uint_t,big_float_t>& CacheFor(mlpg_cache* c, big_uint_t*)
+    { return c ? c->big : FactorCache<big_uint_t,big_float_t>::Shared(); }
+#endif
+
+
+//-----------------------------------------------------------------------------
+struct mlpg_tester {
+//  the order decides between the regular and the bignum types
+//-----------------------------------------------------------------------------
+    mlpg_tester(unsigned ord, mlpg_cache* c) : order(ord), cache(c) {}
+    virtual ~mlpg_tester() {}
+
+    // bits is a binary string of exactly order digits
+    virtual int Test(const std::string& bits) const = 0;
+    virtual long Generate(const std::string* start, const std::string* end,
+        unsigned minTaps, unsigned maxTaps, unsigned long maxCount,
+        mlpg_poly_cb cb, void* user) const = 0;
+    virtual long Random(unsigned long count, mlpg_poly_cb cb, void* user) const = 0;
+
+    unsigned order;
+    mlpg_cache* cache;
+};
+
+
+template<typename poly_t, typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+class TesterImpl : public mlpg_tester {
+//  MLPolyTester::TestPolynomial() only reads its state when no stats
+//  are attached, so it is shared by all threads. A sparse tester has
+//  scratch space, so each thread takes one of its own from the spares,
+//  which are built once and kept for the next test.
+//-----------------------------------------------------------------------------
+  public:
+    typedef SparsePolyTester<poly_t,uintT,fltT> Sparse;
+
+    TesterImpl(unsigned ord, mlpg_cache* c)
+    :   mlpg_tester(ord, c),
+        factors(CacheFor(c, (uintT*)0)),
+        tester(ord, factors.Primes(ord), 0)
+    {}
+
+    ~TesterImpl() {
+        for (unsigned i=0; i<spares.size(); i++)
+            delete spares[i];
+    }
+
+    int Test(const std::string& bits) const {
+        LFSRPolynomial<poly_t> poly(bits);
+        // low-weight polys are much faster by sparse reduction
+        if (poly.NumBitsSet() <= SPARSE_DEFAULT_MAX_TAPS) {
+            Sparse* sparse = TakeSparse();
+            const int result = sparse->TestSparse(poly);
+            GiveSparse(sparse);
+            return result ? MLPG_NOT_ML : MLPG_ML;
+        }
+        return tester.TestPolynomial(poly) ? MLPG_NOT_ML : MLPG_ML;
+    }
+
+    long Generate(const std::string* start, const std::string* end,
+        unsigned minTaps, unsigned maxTaps, unsigned long maxCount,
+        mlpg_poly_cb cb, void* user) const
+    {
+        MLPolyRange<poly_t,uintT,fltT> range(order, &factors);
+        if (start) range.SetStart(LFSRPolynomial<poly_t>(*start));
+        if (end) range.SetEnd(LFSRPolynomial<poly_t>(*end));
+        if (minTaps || maxTaps) range.SetTaps(minTaps, maxTaps ? maxTaps : order);
+
+        long n = 0;
+        typename MLPolyRange<poly_t,uintT,fltT>::iterator it = range.begin();
+        for (; it != range.end() && (!maxCount || (unsigned long)n < maxCount); ++it) {
+            n++;
+            if (Emit(*it, cb, user))
+                break;
+        }
+        return n;
+    }
+
+    long Random(unsigned long count, mlpg_poly_cb cb, void* user) const {
+        long n = 0;
+        while ((unsigned long)n < count) {
+            LFSRPolynomial<poly_t> poly(order);
+            poly.SetRandom();
+            while (tester.TestPolynomial(poly)) {
+                poly.next_candidate();
+                if (poly.end_candidate())
+                    poly = LFSRPolynomial<poly_t>(order);
+            }
+            n++;
+            if (Emit(poly, cb, user))
+                break;
+        }
+        return n;
+    }
+
+  private:
+    Sparse* TakeSparse(void) const {
+        {
+            std::lock_guard<std::mutex> lock(sparesMutex);
+            if (!spares.empty()) {
+                Sparse* sparse = spares.back();
+                spares.pop_back();
+                return sparse;
+            }
+        }
+        return new Sparse(order, factors.Primes(order), 0);
+    }
+
+    void GiveSparse(Sparse* sparse) const {
+        std::lock_guard<std::mutex> lock(sparesMutex);
+        spares.push_back(sparse);
+    }
+
+    static int Emit(const LFSRPolynomial<poly_t>& poly, mlpg_poly_cb cb, void* user) {
+        if (!cb)
+            return 0;
+        std::ostringstream os;
+        os << poly;
+        return cb(os.str().c_str(), user);
+    }
+
+    FactorCache<uintT,fltT>& factors;
+    mutable MLPolyTester<poly_t,uintT,fltT> tester;
+    mutable std::vector<Sparse*> spares;   // as many as threads at once
+    mutable std::mutex sparesMutex;
+};
+
+
+//-----------------------------------------------------------------------------
+struct mlpg_sequence {
+//-----------------------------------------------------------------------------
+    LFSRSequence seq;
+};
+
+
+//-----------------------------------------------------------------------------
+static int HexToBits(const char* str, std::string& bits)
+//  the binary string without leading zeros, as LFSRPolynomial wants it
+//-----------------------------------------------------------------------------
+{
+    if (!str)
+        return MLPG_EINVAL;
+    if (str[0]=='0' && (str[1]=='x' || str[1]=='X'))
+        str += 2;
+    if (!*str)
+        return MLPG_EINVAL;
+    bits.clear();
+    for (; *str; str++) {
+        int digit;
+        if (*str>='0' && *str<='9') digit = *str-'0';
+        else if (*str>='a' && *str<='f') digit = *str-'a'+10;
+        else if (*str>='A' && *str<='F') digit = *str-'A'+10;
+        else return MLPG_EINVAL;
+        for (int bit=3; bit>=0; bit--) {
+            if (!bits.empty() || (digit>>bit)&1)
+                bits += ((digit>>bit)&1) ? '1' : '0';
+        }
+    }
+    return bits.empty() ? MLPG_EINVAL : 0;
+}
+
+//-----------------------------------------------------------------------------
+static void U64ToBits(uint64_t val, std::string& bits)
+//-----------------------------------------------------------------------------
+{
+    bits.clear();
+    for (int bit=63; bit>=0; bit--) {
+        if (!bits.empty() || (val>>bit)&1)
+            bits += ((val>>bit)&1) ? '1' : '0';
+    }
+}
+
+//-----------------------------------------------------------------------------
+static int TestBits(const mlpg_tester* tester, const std::string& bits)
+//-----------------------------------------------------------------------------
+{
+    if (bits.empty())
+        return MLPG_EINVAL;
+    if (bits.size() != tester->order)
+        return MLPG_EORDER;
+    return tester->Test(bits);
+}
+
+
+//=============================================================================
+//  C interface
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+const char* mlpg_version(void)
+//-----------------------------------------------------------------------------
+{
+    return MLPOLYGEN_VERSION;
+}
+
+//-----------------------------------------------------------------------------
+unsigned mlpg_max_order(void)
+//-----------------------------------------------------------------------------
+{
+#ifdef USING_GMP
+    return sizeof(big_poly_t)*8;
+#else
+    return sizeof(reg_poly_t)*8;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+mlpg_cache* mlpg_cache_create(void)
+//-----------------------------------------------------------------------------
+{
+    try {
+        return new mlpg_cache;
+    } catch (...) {
+        return 0;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void mlpg_cache_destroy(mlpg_cache* cache)
+//-----------------------------------------------------------------------------
+{
+    delete cache;
+}
+
+template<typename uintT, typename fltT>
+//-----------------------------------------------------------------------------
+static int FormatPrimes(FactorCache<uintT,fltT>& cache, unsigned order, char* buf, size_t size)
+//-----------------------------------------------------------------------------
+{
+    const std::vector<uintT>& primes = cache.Primes(order);
+    std::ostringstream os;
+    for (unsigned i=0; i<primes.size(); i++)
+        os << (i ? " " : "") << primes[i];
+    if (buf && size)
+        snprintf(buf, size, "%s", os.str().c_str());
+    return int(os.str().size());
+}
+
+//-----------------------------------------------------------------------------
+int mlpg_cache_prepare(mlpg_cache* cache, unsigned order)
+//-----------------------------------------------------------------------------
+{
+    if (!order || order > mlpg_max_order())
+        return MLPG_ERANGE;
+    try {
+        if (order <= sizeof(reg_poly_t)*8)
+            return int(CacheFor(cache, (reg_uint_t*)0).Primes(order).size());
+#ifdef USING_GMP
+        return int(CacheFor(cache, (big_uint_t*)0).Primes(order).size());
+#endif
+    } catch (...) {
+    }
+    return MLPG_EFAIL;
+}
+
+//-----------------------------------------------------------------------------
+int mlpg_cache_factors(mlpg_cache* cache, unsigned order, char* buf, size_t size)
+//-----------------------------------------------------------------------------
+{
+    if (!order || order > mlpg_max_order())
+        return MLPG_ERANGE;
+    try {
+        if (order <= sizeof(reg_poly_t)*8)
+            return FormatPrimes(CacheFor(cache, (reg_uint_t*)0), order, buf, size);
+#ifdef USING_GMP
+        return FormatPrimes(CacheFor(cache, (big_uint_t*)0), order, buf, size);
+#endif
+    } catch (...) {
+    }
+    return MLPG_EFAIL;
+}
+
+//-----------------------------------------------------------------------------
+int mlpg_cache_load(mlpg_cache* cache, const char* fileName)
+//  the reg cache takes the orders up to 64, the big cache those above,
+//  which are the orders each is used for, so every order counts once
+//-----------------------------------------------------------------------------
+{
+    if (!fileName)
+        return MLPG_EINVAL;
+    try {
+        std::ifstream file(fileName);
+        if (!file)
+            return MLPG_EINVAL;
+        int loaded = CacheFor(cache, (reg_uint_t*)0).Load(file);
+#ifdef USING_GMP
+        file.clear();
+        file.seekg(0);
+        loaded += CacheFor(cache, (big_uint_t*)0).Load(file, sizeof(reg_poly_t)*8+1);
+#endif
+        return loaded;
+    } catch (...) {
+    }
+    return MLPG_EFAIL;
+}
+
+//-----------------------------------------------------------------------------
+mlpg_tester* mlpg_tester_create(unsigned order, mlpg_cache* cache)
+//-----------------------------------------------------------------------------
+{
+    if (!order || order > mlpg_max_order())
+        return 0;
+    try {
+        if (order <= sizeof(reg_poly_t)*8)
+            return new TesterImpl<reg_poly_t,reg_uint_t,reg_float_t>(order, cache);
+#ifdef USING_GMP
+        return new TesterImpl<big_poly_t,big_uint_t,big_float_t>(order, cache);
+#endif
+    } catch (...) {
+    }
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+void mlpg_tester_destroy(mlpg_tester* tester)
+//-----------------------------------------------------------------------------
+{
+    delete tester;
+}
+
+//-----------------------------------------------------------------------------
+unsigned mlpg_tester_order(const mlpg_tester* tester)
+//-----------------------------------------------------------------------------
+{
+    return tester ? tester->order : 0;
+}
+
+//-----------------------------------------------------------------------------
+int mlpg_test(const mlpg_tester* tester, const char* poly)
+//-----------------------------------------------------------------------------
+{
+    std::string bits;
+    if (!tester || HexToBits(poly, bits))
+        return MLPG_EINVAL;
+    try {
+        return TestBits(tester, bits);
+    } catch (...) {
+        return MLPG_EFAIL;
+    }
+}
+
+//-----------------------------------------------------------------------------
+int mlpg_test_u64(const mlpg_tester* tester, uint64_t poly)
+//-----------------------------------------------------------------------------
+{
+    std::string bits;
+    if (!tester)
+        return MLPG_EINVAL;
+    U64ToBits(poly, bits);
+    try {
+        return TestBits(tester, bits);
+    } catch (...) {
+        return MLPG_EFAIL;
+    }
+}
+
+template<typename polyT>
+//-----------------------------------------------------------------------------
+static long TestBatch(const mlpg_tester* tester, const polyT* polys, size_t count, int* results, unsigned threads, int (*test)(const mlpg_tester*, polyT))
+//  chunks of the batch are spread over a thread pool
+//-----------------------------------------------------------------------------
+{
+    if (!tester || (count && (!polys || !results)))
+        return MLPG_EINVAL;
+    const size_t chunk = 64;
+    const size_t numChunks = (count+chunk-1)/chunk;
+    try {
+        ThreadPool pool(numChunks>1 ? threads : 1);
+        pool.ParallelFor(unsigned(numChunks), [&](unsigned c, unsigned) {
+            for (size_t i=c*chunk; i<count && i<(c+1)*chunk; i++)
+                results[i] = test(tester, polys[i]);
+        });
+    } catch (...) {
+        return MLPG_EFAIL;
+    }
+    long numML = 0;
+    for (size_t i=0; i<count; i++)
+        numML += results[i]==MLPG_ML;
+    return numML;
+}
+
+//-----------------------------------------------------------------------------
+long mlpg_test_batch(const mlpg_tester* tester, const char* const* polys, size_t count, int* results, unsigned threads)
+//-----------------------------------------------------------------------------
+{
+    return TestBatch<const char*>(tester, polys, count, results, threads, mlpg_test);
+}
+
+//-----------------------------------------------------------------------------
+long mlpg_test_batch_u64(const mlpg_tester* tester, const uint64_t* polys, size_t count, int* results, unsigned threads)
+//-----------------------------------------------------------------------------
+{
+    return TestBatch<uint64_t>(tester, polys, count, results, threads, mlpg_test_u64);
+}
+
+//-----------------------------------------------------------------------------
+long mlpg_generate(const mlpg_tester* tester, const char* start, const char* end,
+                   unsigned min_taps, unsigned max_taps, unsigned long max_count,
+                   mlpg_poly_cb cb, void* user)
+//-----------------------------------------------------------------------------
+{
+    if (!tester || min_taps > (max_taps ? max_taps : tester->order))
+        return MLPG_EINVAL;
+    std::string startBits, endBits;
+    if (start) {
+        if (HexToBits(start, startBits)) return MLPG_EINVAL;
+        if (startBits.size() != tester->order) return MLPG_EORDER;
+    }
+    if (end) {
+        if (HexToBits(end, endBits)) return MLPG_EINVAL;
+        if (endBits.size() != tester->order) return MLPG_EORDER;
+    }
+    try {
+        return tester->Generate(start ? &startBits : 0, end ? &endBits : 0,
+            min_taps, max_taps, max_count, cb, user);
+    } catch (...) {
+        return MLPG_EFAIL;
+    }
+}
+
+//-----------------------------------------------------------------------------
+long mlpg_random(const mlpg_tester* tester, unsigned long count, mlpg_poly_cb cb, void* user)
+//-----------------------------------------------------------------------------
+{
+    if (!tester)
+        return MLPG_EINVAL;
+    try {
+        return tester->Random(count, cb, user);
+    } catch (...) {
+        return MLPG_EFAIL;
+    }
+}
+
+//-----------------------------------------------------------------------------
+mlpg_sequence* mlpg_sequence_create(const char* poly, const char* seed, int convention)
+//-----------------------------------------------------------------------------
+{
+    if (convention!=MLPG_FIBONACCI && convention!=MLPG_GALOIS)
+        return 0;
+    try {
+        GF2Words p, s(1, 1);
+        if (!LFSRSequence::ParseHex(poly, p))
+            return 0;
+        if (seed && !LFSRSequence::ParseState(seed, s))
+            return 0;
+        mlpg_sequence* result = new mlpg_sequence;
+        if (!result->seq.Init(p, LFSRSequence::Convention(convention)) || !result->seq.SetState(s)) {
+            delete result;
+            return 0;
+        }
+        return result;
+    } catch (...) {
+        return 0;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void mlpg_sequence_destroy(mlpg_sequence* seq)
+//-----------------------------------------------------------------------------
+{
+    delete seq;
+}
+
+//-----------------------------------------------------------------------------
+int mlpg_sequence_read(mlpg_sequence* seq, unsigned char* buf, uint64_t num_bits)
+//-----------------------------------------------------------------------------
+{
+    if (!seq || (num_bits && !buf))
+        return MLPG_EINVAL;
+    seq->seq.Read(buf, num_bits);
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+int mlpg_sequence_skip(mlpg_sequence* seq, const char* steps)
+//-----------------------------------------------------------------------------
+{
+    GF2Words k;
+    if (!seq || !LFSRSequence::ParseSteps(steps, k))
+        return MLPG_EINVAL;
+    try {
+        seq->seq.Skip(k);
+    } catch (...) {
+        return MLPG_EFAIL;
+    }
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+int mlpg_sequence_skip_u64(mlpg_sequence* seq, uint64_t steps)
+//-----------------------------------------------------------------------------
+{
+    if (!seq)
+        return MLPG_EINVAL;
+    try {
+        seq->seq.Skip(GF2Words(1, steps));
+    } catch (...) {
+        return MLPG_EFAIL;
+    }
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+int mlpg_sequence_substream(mlpg_sequence* seq, unsigned index, unsigned count)
+//-----------------------------------------------------------------------------
+{
+    if (!seq || index >= count)
+        return MLPG_EINVAL;
+    try {
+        GF2Words length;
+        LFSRSequence::SubstreamLength(seq->seq.Order(), count, length);
+        for (unsigned i=0; i<index; i++)
+            seq->seq.Skip(length);
+    } catch (...) {
+        return MLPG_EFAIL;
+    }
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+int mlpg_state_advance(const char* poly, int convention, const char* state,
+                       const char* steps, char* buf, size_t size)
+//-----------------------------------------------------------------------------
+{
+    if (convention!=MLPG_FIBONACCI && convention!=MLPG_GALOIS)
+        return MLPG_EINVAL;
+    try {
+        GF2Words p, s, k;
+        LFSRSequence seq;
+        if (!LFSRSequence::ParseHex(poly, p) || !LFSRSequence::ParseState(state, s) ||
+            !LFSRSequence::ParseSteps(steps, k) ||
+            !seq.Init(p, LFSRSequence::Convention(convention)) || !seq.Advance(s, k))
+            return MLPG_EINVAL;
+        std::ostringstream os;
+        os << std::hex;
+        unsigned i = unsigned(s.size());
+        while (i>1 && !s[i-1])
+            i--;
+        os << s[--i];
+        while (i>0)
+            os << std::setw(16) << std::setfill('0') << s[--i];
+        if (buf && size)
+            snprintf(buf, size, "%s", os.str().c_str());
+        return int(os.str().size());
+    } catch (...) {
+        return MLPG_EFAIL;
+    }
+}
@@ -20,18 +20,13 @@
 //  along with this program.  If not, see <http://www.gnu.org/licenses/>.
 //=============================================================================
 
-#ifdef USING_GMP
-#include <gmpxx.h>
-#endif
-
-#include "MLPolyTester.h"
+#include "MLPolyModes.h"
 
 #include <cargs.h>
 
-#include <deque>
 #include <stdio.h>
-#include <assert.h>
-#include <iomanip>
+#include <stdlib.h>
+#include <iostream>
 
 #ifndef MLPOLYGEN_VERSION
 #define MLPOLYGEN_VERSION "UNKNOWN"
@@ -42,17 +37,45 @@ static struct cag_option options[] = {
     {'b', "b", NULL, NULL, "use bignum library (GMP), may be auto-selected by order" },
 #endif
     {'p', "p", NULL, NULL, "use symmetric pairs (faster but unsorted output)"},
+    {'S', NULL, "sorted", NULL,
+        "with '-p': print in sorted order, holding back the duals\n"
+        "\tuntil the search has passed them"},
+    {'M', NULL, "sort-memory", "MiB",
+        "memory for the held back duals of '--sorted', before they are\n"
+        "\tspilled to temporary files. default: 64"},
     {'c', "c", NULL, NULL, "print polynomials amended with count of taps"},
-    {'2', "2", NULL, NULL, "search for polynomials with only 2 taps for specified order"},
+    {'2', "2", NULL, NULL,
+        "search for polynomials with only 2 taps for specified order,\n"
+        "\tof any size when 2**order-1 is a Mersenne prime"},
 
     {'u', "u", NULL, "shiftUp", "for option '-f': first enabled tap. default: 0"},
     {'f', "f", NULL, "bits",
         "bruteForce: how many taps(bits) should be tested sequenctially:\n"
         "\tall possible combinations for taps u .. u+f-1 are tested\n"
-        "\tdefault: 0 for off.limitation : all taps need to fit into 64 Bits!"},
+        "\tdefault: 0 for off. limitation: at most 63 taps"},
+    {'T', NULL, "taps", "list",
+        "bruteForce over any set of taps, given as exponents of x,\n"
+        "\te.g. 1,5,9-12. Tests the top tap plus all their combinations.\n"
+        "\tcan be combined with -m, -w and -n"},
+    {'j', "j", NULL, "threads",
+        "number of threads for '-f', '--taps', and '-t' of orders from 128.\n"
+        "\tdefault: 0, one per CPU"},
     {'m', "m", NULL, "int",
         "print only polynomials with number of taps <= this value\n"
+        "\tonly such candidates are enumerated and tested\n"
         "\tdefault is -1, to print all polynomials"},
+    {'w', "w", NULL, "int",
+        "print only polynomials with exactly this number of taps\n"
+        "\tonly such candidates are enumerated and tested"},
+    {'k', NULL, "sparse-taps", "int",
+        "for options '-2', '-f', '-m' and '-w': test polynomials with at most\n"
+        "\tthis many taps by sparse reduction instead of the matrix method.\n"
+        "\tdefault: that of '--tune' for order, which also applies to\n"
+        "\tthe search of all polynomials, else 16. 0 to disable"},
+    {'y', NULL, "tune", NULL,
+        "time sparse reduction against the matrix method for order\n"
+        "\ton this CPU, and keep the fastest '--sparse-taps' in\n"
+        "\t~/.mlpolygen_tune (or $MLPOLYGEN_TUNE) for later runs"},
     {'s', "s", NULL, "start",
         "start with specified polynomial (order is computed, not required)"},
     {'e', "e", NULL, "end",
@@ -61,8 +84,105 @@ static struct cag_option options[] = {
         "stop after specified number of ML polynomials"},
 
     {'r', "r", NULL, NULL, "compute random ML polys (may not be unique, can use with -n)"},
+    {'g', NULL, "gold", NULL,
+        "print the preferred pairs of ML polys of order (3..64, not\n"
+        "\tdivisible by 4) and their product, for Gold codes, once\n"
+        "\teach. With -s, only the pairs of that poly"},
+    {'q', NULL, "kasami", NULL,
+        "print each ML poly of even order (4..64), the poly of its\n"
+        "\tdecimation by 2**(order/2)+1, and their product, for the\n"
+        "\tsmall Kasami set. With -s, only for that poly"},
+    {'Y', NULL, "cosets", NULL,
+        "compute all ML polys of order (2..64) from the first one,\n"
+        "\tone per cyclotomic coset, on the threads of -j. Sorted,\n"
+        "\tunless with -p (then '--sorted' applies). With -n, those\n"
+        "\tof the first cosets"},
+    {'O', NULL, "period", "poly",
+        "print the period of poly (any order), the order of x modulo\n"
+        "\tpoly, by factoring it. May be repeated, '-' reads polys from stdin"},
     {'t', "t", NULL, "poly",
         "test the specified polynomial (order is computed, not required)"},
+    {'i', NULL, "irreducible", NULL,
+        "for '-t', '-r' and the search of order: irreducible instead of\n"
+        "\tML polys, by Rabin's test, without factoring 2**order-1"},
+
+    {'L', NULL, "factor-cache", "file",
+        "the factors of 2**n-1 from a file written by PrimeFactorizer -s,\n"
+        "\tinstead of factoring them"},
+
+    {'P', NULL, "progress", "seconds",
+        "print a progress line with throughput and ETA to stderr\n"
+        "\tevery this many seconds. SIGUSR1 prints one on demand"},
+    {'F', NULL, "profile", NULL,
+        "read the hardware performance counters (Linux perf events)\n"
+        "\tper stage, and print IPC and misses per candidate at exit"},
+    {'J', NULL, "stats-json", "file",
+        "write run statistics as JSON to file at exit ('-' for stderr)"},
+
+    {'I', NULL, "build-index", NULL,
+        "write the index of all ML polynomials of order (2..32)\n"
+        "\tto the file of '--index', default mlpolyORDER.idx"},
+    {'X', NULL, "index", "file",
+        "answer '-t', '--kth', '--next' and '--count' from this index\n"
+        "\twhen it is of the same order, else they test candidates"},
+    {'K', NULL, "kth", "k",
+        "print the k-th ML polynomial of order, from 1"},
+    {'N', NULL, "next", "poly",
+        "print the first ML polynomial after poly"},
+    {'C', NULL, "count", NULL,
+        "print the number of ML polynomials of order, or from -s to -e"},
+
+    {'R', NULL, "orders", "A-B",
+        "one JSON record per order from A to B, on the threads of -j:\n"
+        "\tthe first -n ML polys, all with 2 taps (-2), the first with\n"
+        "\tthe fewest taps (--min-weight) and the count (--count).\n"
+        "\tdefault: all of these, with -n 1"},
+    {'W', NULL, "min-weight", NULL,
+        "for '--orders': the first ML polynomial with the fewest taps"},
+    {'z', NULL, "sparsest", "order",
+        "print the ML polynomial of '--min-weight' from a built-in\n"
+        "\ttable, without a search. May be repeated, '-c' adds the taps"},
+    {'V', NULL, "verify", NULL,
+        "for '--sparsest': test the polynomial from the table again"},
+
+    {'D', NULL, "serve", "socket",
+        "serve test/next/random/batch requests on a Unix socket,\n"
+        "\tone line each, until SIGINT or SIGTERM"},
+
+    {'o', NULL, "coordinator", "address",
+        "lease the candidates of order in ranges to '--worker'\n"
+        "\tprocesses, on a Unix socket path or TCP [host]:port, and\n"
+        "\twrite their results to a file per range. Resumes the\n"
+        "\tsearch in '--lease-dir'. With -p, in pairs"},
+    {'x', NULL, "worker", "address",
+        "search the ranges of a '--coordinator' until it is done"},
+    {'l', NULL, "lease-bits", "bits",
+        "for '--coordinator': split the candidates into 2**bits\n"
+        "\tranges. default: order-20, from 0 to 16"},
+    {'d', NULL, "lease-dir", "dir",
+        "for '--coordinator': the directory of the files of the\n"
+        "\tranges and of mlpolyORDER.done. default: ."},
+    {'a', NULL, "lease-time", "seconds",
+        "for '--coordinator': lease a range again when it is not\n"
+        "\tcompleted in this time. default: 600"},
+
+    {'E', NULL, "emit-sequence", "poly",
+        "write the output bits of an LFSR with poly (any order) to\n"
+        "\tstdout as raw binary, the first bit in bit 0 of byte 0"},
+    {'B', NULL, "bits", "N",
+        "for '--emit-sequence': the number of bits.\n"
+        "\tdefault: 0, until the output is closed"},
+    {'G', NULL, "galois", NULL,
+        "for '--emit-sequence': use a Galois LFSR, default: Fibonacci"},
+    {'Z', NULL, "seed", "state",
+        "for '--emit-sequence': the initial state in hex, default: 1"},
+    {'A', NULL, "skip", "steps",
+        "for '--emit-sequence': jump ahead this many steps first,\n"
+        "\tdecimal or hex with 0x, of any size"},
+    {'Q', NULL, "substream", "i/N",
+        "for '--emit-sequence': jump to the start of the i-th of N\n"
+        "\tequally spaced substreams (from 0), and by default emit\n"
+        "\tits (2**order-1)/N bits"},
 
     {'v', "v", NULL, NULL, "increase verbosity"},
     {'h', "h?", "help", NULL, "this help"},
@@ -86,342 +206,12 @@ void usage(const char* argv0)
     printf("mlpolygen version %s\n", MLPOLYGEN_VERSION);
 }
 
-
-template <typename uintT>
-//-----------------------------------------------------------------------------
-int GetUintAsBinaryStr(const char str[], uintT & val, std::string& ostr)
-//  because that's what bitset wants
-//-----------------------------------------------------------------------------
-{
-    std::stringstream ss(str);
-
-    // leading 0x indicates hex, leading 0 indicates oct
-    if (ss.peek() == '0') {
-        char c;
-        ss.get(c);
-        c = ss.peek();
-        if (c == 'x' || c == 'X') {
-            ss.get(c);
-            ss.setf(std::ios::hex, std::ios::basefield);
-        } else {
-            ss.setf(std::ios::oct, std::ios::basefield);
-        }
-    }
-    
-    // get the value
-    bool extracted = !!(ss >> val);
-    if (!extracted)
-        return -1;
-    while (!ss.eof()) {
-        char c;
-        if (ss >> c)
-            return -1; // non-whitespace remained
-    }
-    
-    // now write it to ostr as a binary string 
-    uintT val2 = val;
-    std::deque<char> bdeq;
-    while (val2!=0) {
-        bdeq.push_front( (val2&uintT(1))!=0 ? '1' : '0' );
-        val2 /= 2;
-    }
-    
-    while (bdeq.size()) {
-        ostr += bdeq[0];
-        bdeq.pop_front();
-    }
-    
-    return 0;
-}
-
-template<typename poly_t, typename uintT, typename fltT>
-//-----------------------------------------------------------------------------
-int TestSinglePolynomial(const char str[], int verbosity=0)
-//-----------------------------------------------------------------------------
-{
-    std::string bstr;
-    uintT val;
-    int result = GetUintAsBinaryStr<uintT>(str,val,bstr);
-    if (result) {
-        std::cerr << "Error converting to uint" << sizeof(uintT)*8;
-        std::cerr << ": " << str << std::endl;
-        return result;
-    }
-
-    LFSRPolynomial<poly_t> poly(bstr.c_str());
-    MLPolyTester<poly_t,uintT,fltT> polyTester(poly.Order(),verbosity);
-    result = polyTester.TestPolynomial(poly);
-
-    std::cout << std::hex << std::setiosflags( std::ios::showbase );
-    std::cout << val << " is ";
-    if (result)
-        std::cout << "NOT ";
-    std::cout << "maximal length";
-    std::cout << " for order " << std::dec << poly.Order() << std::endl;
-    std::cout << std::resetiosflags(std::ios::showbase | std::ios::basefield);
-    return result;
-}
-
-template<typename poly_t, typename uintT, typename fltT>
-//-----------------------------------------------------------------------------
-unsigned FindTwoTapPolynomials(unsigned order, int verbosity=0)
-//-----------------------------------------------------------------------------
-{
-    LFSRPolynomial<poly_t> poly(order);
-    MLPolyTester<poly_t,uintT,fltT> polyTester(poly.Order(),verbosity);
-    unsigned n_results = 0;
-    int result;
-
-    std::cout << std::hex << std::resetiosflags(std::ios::showbase | std::ios::basefield);
-    for (unsigned k = 0; k < order -1; ++k)
-    {
-        poly.Clear();
-        poly.set(order -1, 1);
-        poly.set(k, 1);
-
-        result = polyTester.TestPolynomial(poly);
-        if (result)
-            continue;
-        ++n_results;
-        std::cout << std::dec << n_results << ": 0x" << poly;
-        if (verbosity >= 1) {
-            const unsigned n_taps_set = poly.NumBitsSet();
-            std::cout << "\t# " << std::dec << n_taps_set;
-            if (verbosity >= 2)
-                std::cout << ": 0," << k+1 << "," << order;
-        }
-        std::cout << std::endl;
-    }
-    std::cout << std::dec;
-    return n_results;
-}
-
-template<typename poly_t, typename uintT, typename fltT>
-//-----------------------------------------------------------------------------
-unsigned BruteForceFindPolynomials(int shiftUp, int bruteForceNumBits, unsigned order, int verbosity=0)
-//-----------------------------------------------------------------------------
-{
-    if (order > 64) {
-        std::cerr << "order = " << order
-            << ": only values <= 64 supported!" << std::endl;
-        return 0;
-    }
-    if (shiftUp < 0) {
-        std::cerr << "shiftUp = " << shiftUp
-            << ": only values >= 0 supported!" << std::endl;
-        return 0;
-    }
-    if (bruteForceNumBits <= 0) {
-        std::cerr << "bruteForceNumBits = " << bruteForceNumBits
-            << ": only values > 0 supported!" << std::endl;
-        return 0;
-    }
-    if (shiftUp+bruteForceNumBits >= order) {
-        std::cerr << "shiftUp + bruteForceNumBits = " << shiftUp + bruteForceNumBits
-            << ": only values < 'order' supported!" << std::endl;
-        return 0;
-    }
-
-    LFSRPolynomial<poly_t> poly(order);
-    MLPolyTester<poly_t,uintT,fltT> polyTester(poly.Order(),verbosity);
-    unsigned n_results = 0;
-    int result;
-
-    std::cout << std::hex << std::resetiosflags(std::ios::showbase | std::ios::basefield);
-    uint64_t forceNmax = 0;
-    for (unsigned k = 0; k < bruteForceNumBits; ++k)
-        forceNmax |= (uint64_t(1) << k);
-    for (uint64_t comb = 1; comb <= forceNmax; ++comb)
-    {
-        poly.Clear();
-        poly.set(order -1, 1);
-        for (unsigned k = 0; k < bruteForceNumBits; ++k) {
-            if ( (comb >> k) & 1 ) {
-                assert( shiftUp + k != order -1 );
-                poly.set(shiftUp + k, 1);
-            }
-        }
-
-        result = polyTester.TestPolynomial(poly);
-        if (result)
-            continue;
-        ++n_results;
-        std::cout << std::dec << n_results << ": 0x" << poly;
-        if (verbosity >= 1) {
-            const unsigned n_taps_set = poly.NumBitsSet();
-            std::cout << "\t# " << std::dec << n_taps_set;
-            if (verbosity >= 1) {
-                std::cout << ": 0";
-                for (unsigned k = 0; k < order; ++k) {
-                    if (poly[k])
-                        std::cout << "," << k+1;
-                }
-            }
-        }
-        std::cout << std::endl;
-    }
-    std::cout << std::dec;
-    return n_results;
-}
-
-
-template<typename poly_t, typename uintT, typename fltT>
-//-----------------------------------------------------------------------------
-int GenerateRandomPolys(unsigned long order, unsigned long numRands, int verbosity=0)
-//-----------------------------------------------------------------------------
-{
-    MLPolyTester<poly_t,uintT,fltT> polyTester(order,verbosity);
-    while (numRands) {
-        LFSRPolynomial<poly_t> poly(order);
-        poly.SetRandom();
-        if (1<=verbosity) {
-            std::cerr << "Random poly: " << poly << std::endl;
-        }
-        while (1) {
-            int result = polyTester.TestPolynomial(poly);
-            if (!result) {
-                std::cout << poly << std::endl;
-                numRands--;
-                break;
-            }
-            poly.next_candidate();
-            if (poly.end_candidate()) {
-                poly = LFSRPolynomial<poly_t>(order);
-            }
-            if (2<=verbosity) {
-                std::cerr << "Next poly: " << poly << std::endl;
-            }
-        }
-    }
-    return 0;
-}
-
-template<typename poly_t, typename uintT, typename fltT>
-//-----------------------------------------------------------------------------
-int GeneratePolySequence(unsigned long order, const char* startVal, const char* endVal, unsigned long numPolys, bool inPairs, int verbosity=0, bool printCountTaps =false, int maximum_taps =-1)
-//-----------------------------------------------------------------------------
-{
-    LFSRPolynomial<poly_t> poly(order?order:1); // use a dummy when !order
-    if (startVal) {
-        std::string bstr;
-        uintT val;
-        int result = GetUintAsBinaryStr<uintT>(startVal,val,bstr);
-        if (result) {
-            std::cerr << "Error converting to uint" << sizeof(uintT)*8;
-            std::cerr << ": " << startVal << std::endl;
-            return result;
-        }
-        poly = LFSRPolynomial<poly_t>(bstr);
-    }
-    LFSRPolynomial<poly_t> endPoly(1);
-    if (endVal) {
-        std::string bstr;
-        uintT val;
-        int result = GetUintAsBinaryStr<uintT>(endVal,val,bstr);
-        if (result) {
-            std::cerr << "Error converting to uint" << sizeof(uintT)*8;
-            std::cerr << ": " << endVal << std::endl;
-            return result;
-        }
-        endPoly = LFSRPolynomial<poly_t>(bstr);
-    }
-    if (startVal && endVal) {
-        if (poly.Order() != endPoly.Order()) {
-            std::cerr << "Error: order for start and end values must match (";
-            std::cerr << poly.Order() << " vs " << endPoly.Order() << ")" << std::endl;
-            return -1;
-        }
-    }
-    if (!startVal && endVal) {
-    	poly = LFSRPolynomial<poly_t>(endPoly.Order());
-    }
-    if ((startVal || endVal) && order && (poly.Order() != order)) {
-        std::cerr << "Order multiply specified as " << poly.Order() << " and " << order;
-        std::cerr << ", using " << poly.Order() << " from the start value" << std::endl;
-    }
-    order = poly.Order();
-
-    if (1<=verbosity && !numPolys) {
-        std::cerr << "Generating maximal length polynomials of order " << order << "," << std::endl;
-        LFSRPolynomial<poly_t> opoly = poly;
-        std::cerr << "  from 0x" << opoly;
-        if (endVal) opoly = endPoly;
-        else opoly.SetMax();
-        std::cerr << " to 0x" << opoly;
-        if (inPairs)
-            std::cerr << " (in pairs)";
-        std::cerr << std::endl;
-    }
-
-    MLPolyTester<poly_t,uintT,fltT> polyTester(order,verbosity);
-    unsigned long polysFound = 0;
-    while (1) {
-        while (inPairs && (poly.IsAsymmetric()==1) && !poly.end_candidate()) {
-            poly.next_candidate();
-        }
-        if (poly.end_candidate()) { // have we reached the last possible candidate?
-            break;
-        }
-        if (numPolys && polysFound>=numPolys) { // have we already found enough?
-            break;
-        }
-        if (endVal && endPoly<poly) { // have we passed a spec's endVal?
-            break;
-        }
-        if (2<=verbosity) {
-            std::cerr << "candidate: " << poly << std::endl;
-        }
-        int result = polyTester.TestPolynomial(poly);
-        if (!result) {
-            const unsigned n_taps_set = poly.NumBitsSet();
-            if (maximum_taps == -1 || n_taps_set <= maximum_taps) {
-                if (!printCountTaps)
-                    std::cout << poly << std::endl;
-                else
-                    std::cout << poly << "\t# " << std::dec << n_taps_set << std::endl;
-                polysFound++;
-                if (inPairs && (poly.IsAsymmetric()==-1)) { // is asymmetric and has more lower bits
-                    std::cout << poly.SymmetricDual() << std::endl;
-                    polysFound++;
-                }
-            }
-        }
-        poly.next_candidate();
-    }
-    return 0;
-}
-
-typedef default_poly_t reg_poly_t;
-typedef uintmax_t reg_uint_t;
-typedef long double reg_float_t;
-
-#ifdef USING_GMP
-typedef std::bitset<1024> big_poly_t;
-typedef mpz_class big_uint_t;
-typedef mpf_class big_float_t;
-#endif
-
-
-
 //-----------------------------------------------------------------------------
 int main(int argc, char* argv[])
 //-----------------------------------------------------------------------------
 {
     const char* argv0 = argv[0];
-    int bignum = 0;
-    int verbosity = 0;
-    int result = 0;
-    int tested = 0;
-    int maximum_taps = -1;
-    int shiftUp = 0;
-    int bruteForceNumBits = 0;
-    bool inPairs = 0;
-    bool doRandom = 0;
-    bool printCountTaps = false;
-    bool findTwoTaps = false;
-    const char* startVal = 0;
-    const char* endVal = 0;
-    unsigned long numPolys = 0;
+    MLPolyOptions opts;
 
     cag_option_context context;
     cag_option_prepare(&context, options, CAG_ARRAY_SIZE(options), argc, argv);
@@ -430,43 +220,57 @@ int main(int argc, char* argv[])
         char* endp;
         switch (cag_option_get(&context)) {
             case 't':
-                optarg = cag_option_get_value(&context);
-                if (!bignum) {
-                    result += TestSinglePolynomial<reg_poly_t,reg_uint_t,reg_float_t>(optarg, verbosity);
-#ifdef USING_GMP
-                } else {
-                    result += TestSinglePolynomial<big_poly_t,big_uint_t,big_float_t>(optarg, verbosity);
-#endif
-                }
-                tested++;
+                opts.testPolys.push_back(std::make_pair(cag_option_get_value(&context), opts.bignum));
+                break;
+            case 'O':
+                opts.periodPolys.push_back(cag_option_get_value(&context));
                 break;
             case 'r':
-                doRandom = 1;
+                opts.doRandom = 1;
+                break;
+            case 'i':
+                opts.irreducible = true;
                 break;
             case 'c':
-                printCountTaps = true;
+                opts.printCountTaps = true;
                 break;
             case 'm':
-                maximum_taps = atoi(cag_option_get_value(&context));
+                opts.maximum_taps = atoi(cag_option_get_value(&context));
+                break;
+            case 'w':
+                opts.exact_taps = atoi(cag_option_get_value(&context));
+                break;
+            case 'k':
+                opts.sparseTaps = atoi(cag_option_get_value(&context));
+                opts.sparseTapsSet = true;
+                break;
+            case 'y':
+                opts.tune = true;
                 break;
             case 'u':
-                shiftUp = atoi(cag_option_get_value(&context));
+                opts.shiftUp = atoi(cag_option_get_value(&context));
                 break;
             case 'f':
-                bruteForceNumBits = atoi(cag_option_get_value(&context));
+                opts.bruteForceNumBits = atoi(cag_option_get_value(&context));
+                break;
+            case 'T':
+                opts.tapListStr = cag_option_get_value(&context);
+                break;
+            case 'j':
+                opts.numThreads = atoi(cag_option_get_value(&context));
                 break;
             case '2':
-                findTwoTaps = true;
+                opts.findTwoTaps = true;
                 break;
             case 's':
-                startVal = cag_option_get_value(&context);
+                opts.startVal = cag_option_get_value(&context);
                 break;
             case 'e':
-                endVal = cag_option_get_value(&context);
+                opts.endVal = cag_option_get_value(&context);
                 break;
             case 'n':
                 optarg = cag_option_get_value(&context);
-                numPolys = strtoul(optarg,&endp,0);
+                opts.numPolys = strtoul(optarg,&endp,0);
                 if (endp[0]) {
                     std::cerr << "Error converting to uint: " << optarg << std::endl;
                     return -1;
@@ -474,14 +278,114 @@ int main(int argc, char* argv[])
                 break;
 #ifdef USING_GMP
             case 'b':
-                bignum = 1;
+                opts.bignum = 1;
                 break;
 #endif
             case 'p':
-                inPairs = 1;
+                opts.inPairs = 1;
+                break;
+            case 'S':
+                opts.sorted = true;
+                break;
+            case 'M':
+                opts.sortMemory = size_t(atof(cag_option_get_value(&context)) * (1<<20));
+                break;
+            case 'P':
+                opts.progressSeconds = atof(cag_option_get_value(&context));
+                break;
+            case 'J':
+                opts.statsJSON = cag_option_get_value(&context);
+                break;
+            case 'F':
+                opts.profile = true;
+                break;
+            case 'L':
+                opts.factorCacheFile = cag_option_get_value(&context);
+                break;
+            case 'D':
+                opts.servePath = cag_option_get_value(&context);
+                break;
+            case 'o':
+                opts.coordinatorAddress = cag_option_get_value(&context);
+                break;
+            case 'x':
+                opts.workerAddress = cag_option_get_value(&context);
+                break;
+            case 'l':
+                opts.leaseBits = atoi(cag_option_get_value(&context));
+                break;
+            case 'd':
+                opts.leaseDir = cag_option_get_value(&context);
+                break;
+            case 'a':
+                opts.leaseSeconds = atof(cag_option_get_value(&context));
+                break;
+            case 'E':
+                opts.emitPoly = cag_option_get_value(&context);
+                break;
+            case 'B':
+                optarg = cag_option_get_value(&context);
+                opts.numBits = strtoull(optarg,&endp,0);
+                if (endp[0]) {
+                    std::cerr << "Error converting to uint: " << optarg << std::endl;
+                    return -1;
+                }
+                break;
+            case 'G':
+                opts.galois = true;
+                break;
+            case 'Z':
+                opts.seed = cag_option_get_value(&context);
+                break;
+            case 'A':
+                opts.skipSteps = cag_option_get_value(&context);
+                break;
+            case 'Q':
+                opts.substream = cag_option_get_value(&context);
+                break;
+            case 'I':
+                opts.buildIndex = true;
+                break;
+            case 'X':
+                opts.indexFile = cag_option_get_value(&context);
+                break;
+            case 'K':
+                opts.kth = strtoul(cag_option_get_value(&context),&endp,0);
+                break;
+            case 'N':
+                opts.nextAfter = cag_option_get_value(&context);
+                break;
+            case 'C':
+                opts.countRange = true;
+                break;
+            case 'R':
+                opts.sweepOrders = cag_option_get_value(&context);
+                break;
+            case 'W':
+                opts.minWeight = true;
+                break;
+            case 'z':
+                optarg = cag_option_get_value(&context);
+                opts.sparsestOrders.push_back(strtoul(optarg,&endp,0));
+                if (endp==optarg || endp[0]) {
+                    std::cerr << "Error converting to uint: " << optarg << std::endl;
+                    return -1;
+                }
+                break;
+            case 'V':
+                opts.verify = true;
+                break;
+            case 'Y':
+                opts.cosets = true;
+                break;
+            case 'g':
+                opts.gold = true;
+                break;
+            case 'q':
+                opts.kasami = true;
                 break;
             case 'v':
-                verbosity++;
+                opts.verbosity++;
                 break;
             case '?':
             case 'h':
@@ -501,83 +405,12 @@ int main(int argc, char* argv[])
         usage(argv0);
         return -1;
     }
-    if (tested) {
-        if (argc) {
-            std::cerr << "Note: option -t excludes the argument order" << std::endl;
-        }
-        return result;
-    }
-    unsigned long order = 0;
-    if (argc) {
-        char* endp;
-        order = strtoul(argv[0],&endp,0);
-        if (endp[0]) {
-            std::cerr << "Error converting to uint: " << argv[0] << std::endl;
-            return -1;
-        }
-    } else if (!startVal && !endVal) {
+
+    opts.orderArg = argc ? argv[0] : 0;
+    if (!argc && MLPolyNeedsOrder(opts)) {
         std::cerr << "Error: not enough arguments" << std::endl;
         usage(argv0);
         return -1;
     }
-    if (order>sizeof(reg_poly_t)*8 && !bignum) {
-        std::cerr << "Maximum order (without bignum/GMP) is " << sizeof(reg_poly_t)*8;
-#ifdef USING_GMP
-        std::cerr << ", setting bignum" << std::endl;
-        bignum = 1;
-    }
-    if (order>sizeof(big_poly_t)*8 && !bignum) {
-        std::cerr << "Maximum order is " << sizeof(big_poly_t)*8;
-#endif
-        std::cerr << std::endl;
-        return -1;
-    }
-
-    if (findTwoTaps) {
-        unsigned n_results = 0;
-        if (!bignum)
-            n_results = FindTwoTapPolynomials<reg_poly_t,reg_uint_t,reg_float_t>(order, verbosity);
-#ifdef USING_GMP
-        else
-            n_results += FindTwoTapPolynomials<big_poly_t,big_uint_t,big_float_t>(order, verbosity);
-#endif
-        std::cout << "found " << std::dec << n_results << " polynomials with 2 taps, order "
-            << order << " and maximal length" << std::endl;
-        return 0;
-    }
-
-    if (bruteForceNumBits) {
-        unsigned n_results = 0;
-        if (!bignum)
-            n_results = BruteForceFindPolynomials<reg_poly_t,reg_uint_t,reg_float_t>(shiftUp, bruteForceNumBits, order, verbosity);
-#ifdef USING_GMP
-        else
-            n_results += BruteForceFindPolynomials<big_poly_t,big_uint_t,big_float_t>(shiftUp, bruteForceNumBits, order, verbosity);
-#endif
-        std::cout << "found " << std::dec << n_results << " polynomials with all taps - except top - in "
-            << shiftUp << " .. " << shiftUp + bruteForceNumBits
-            << " of order " << order << " and maximal length" << std::endl;
-        return 0;
-    }
-
-    if (doRandom) {
-        if (inPairs || startVal || endVal)
-            std::cerr << "Note: option -r excludes these options: -p -s -e " << std::endl;
-        if (!numPolys) numPolys = 1;
-        if (order<=sizeof(reg_poly_t)*8 && !bignum) {
-            return GenerateRandomPolys<reg_poly_t,reg_uint_t,reg_float_t>(order,numPolys,verbosity);
-#ifdef USING_GMP
-        } else {
-            return GenerateRandomPolys<big_poly_t,big_uint_t,big_float_t>(order,numPolys,verbosity);
-#endif
-        }
-    }
-    
-    if (!bignum) {
-        return GeneratePolySequence<reg_poly_t,reg_uint_t,reg_float_t>(order,startVal,endVal,numPolys,inPairs,verbosity,printCountTaps,maximum_taps);
-#ifdef USING_GMP
-    } else {
-        return GeneratePolySequence<big_poly_t,big_uint_t,big_float_t>(order,startVal,endVal,numPolys,inPairs,verbosity,printCountTaps,maximum_taps);
-#endif
-    }
+    return MLPolyRun(opts);
 }
@@ -0,0 +1,187 @@
+#!/usr/bin/env python
+# This file is part of MLPolyGen, a maximal-length polynomial generator
+# for linear feedback shift registers.
+#
+# Copyright (C) 2012  Gregory E. Allen
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+# This file writes SparsestTable.h, the minimum-weight ML polynomial
+# of each order, for mlpolygen --sparsest. Usage:
+#   make_sparsest_table.py [-j threads] [-t seconds] [-L factors.txt]
+#       MLPOLYGEN LAST > SparsestTable.h
+# Each order is searched with mlpolygen --orders=N --min-weight, which
+# gives the first polynomial of the fewest taps, and then tested again
+# with mlpolygen -t. Orders that take longer than the time limit (most
+# often because 2**N-1 is hard to factor) are left out of the table and
+# listed in its header; a factor cache (-L, see PrimeFactorizer -s) with
+# the published factorizations of 2**N-1 fills them in.
+
+import json
+import subprocess
+import sys
+import textwrap
+import threading
+
+MAX_TAPS = 3 # exponents between 0 and the order, a pentanomial
+
+def Search(mlpolygen, order, seconds, factorCache):
+	args = [mlpolygen, '-b']
+	if factorCache:
+		args.append('--factor-cache=' + factorCache)
+	try:
+		out = subprocess.check_output(args + ['--orders=%d' % order, '--min-weight'],
+			timeout=seconds, stderr=subprocess.DEVNULL)
+		poly = json.loads(out.decode('ascii'))['min_weight']
+		out = subprocess.check_output(args + ['-t', '0x' + poly],
+			timeout=seconds, stderr=subprocess.DEVNULL).decode('ascii')
+	except (subprocess.SubprocessError, ValueError, KeyError):
+		return None
+	if 'NOT' in out or 'maximal length for order %d' % order not in out:
+		raise RuntimeError('order %d: %s failed the test' % (order, poly))
+	# bit i is x**(i+1), the top one is x**order
+	value = int(poly, 16)
+	taps = [ i+1 for i in range(order-2, -1, -1) if (value >> i) & 1 ]
+	if value >> (order-1) != 1 or len(taps) > MAX_TAPS:
+		raise RuntimeError('order %d: %s does not fit the table' % (order, poly))
+	return taps
+
+def Ranges(orders):
+	ranges = []
+	for n in orders:
+		if ranges and ranges[-1][1] == n-1:
+			ranges[-1][1] = n
+		else:
+			ranges.append([n, n])
+	return ', '.join([ '%d' % a if a == b else '%d-%d' % (a, b) for a, b in ranges ])
+
+def PrintTable(last, table):
+	missing = [ n for n in range(2, last+1) if n not in table ]
+	print('''//=============================================================================
+//  The minimum-weight ML polynomial of each order, for --sparsest
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+//  Written by make_sparsest_table.py, do not edit.
+//=============================================================================
+
+#ifndef SparsestTable_h
+#define SparsestTable_h
+#pragma once
+
+#include <stdint.h>
+
+// orders from 2 to sparsestMaxOrder, except those listed here
+%s
+static constexpr unsigned sparsestMaxOrder = %d;
+
+// per order, the exponents of the taps between x**order and 1 in
+// decreasing order, then zeros: x**order + x**a + x**b + x**c + 1.
+// For the first ML polynomial (in mlpolygen order) of the fewest taps.
+static constexpr uint16_t sparsestTaps[%d][%d] = {''' % ('\n'.join(textwrap.wrap('not in the table: ' + (Ranges(missing) or 'none'),
+		76, initial_indent='// ', subsequent_indent='//     ')), last, last+1, MAX_TAPS))
+	for row in range(0, last+1, 8):
+		entries = []
+		for n in range(row, min(row+8, last+1)):
+			taps = table.get(n, []) + [0]*MAX_TAPS
+			entries.append('{%s}' % ','.join([ '%d' % t for t in taps[:MAX_TAPS] ]))
+		print('    /* %4d */ %s,' % (row, ', '.join(entries)))
+	print('''};
+
+
+//-----------------------------------------------------------------------------
+inline unsigned SparsestTaps(unsigned order, unsigned taps[%d])
+//  the number of exponents written to taps, 0 if order is not in the table
+//-----------------------------------------------------------------------------
+{
+    if (order > sparsestMaxOrder)
+        return 0;
+    unsigned num = 0;
+    while (num < %d && sparsestTaps[order][num]) {
+        taps[num] = sparsestTaps[order][num];
+        num++;
+    }
+    return num;
+}
+
+#endif''' % (MAX_TAPS, MAX_TAPS))
+
+def main(argv):
+	numThreads, seconds, factorCache = 1, 60, None
+	while len(argv) > 2 and argv[0] in ('-j', '-t', '-L'):
+		if argv[0] == '-j':
+			numThreads = int(argv[1])
+		elif argv[0] == '-t':
+			seconds = float(argv[1])
+		else:
+			factorCache = argv[1]
+		argv = argv[2:]
+	if len(argv) != 2:
+		sys.stderr.write('usage: make_sparsest_table.py [-j threads] [-t seconds] [-L factors.txt] MLPOLYGEN LAST\n')
+		return 1
+	mlpolygen = argv[0]
+	first, last = 2, int(argv[1])
+
+	table = {}
+	errors = []
+	todo = list(range(last, first-1, -1)) # largest first, they take longest
+	lock = threading.Lock()
+	def Worker():
+		while True:
+			with lock:
+				if not todo:
+					return
+				order = todo.pop(0)
+			try:
+				taps = Search(mlpolygen, order, seconds, factorCache)
+			except RuntimeError as e:
+				taps = None
+				errors.append(str(e))
+			with lock:
+				if taps:
+					table[order] = taps
+				sys.stderr.write('%d: %s\n' % (order, taps))
+	threads = [ threading.Thread(target=Worker) for i in range(numThreads) ]
+	for t in threads:
+		t.start()
+	for t in threads:
+		t.join()
+	if errors:
+		sys.stderr.write('\n'.join(errors) + '\n')
+		return 1
+	missing = len([ n for n in range(first, last+1) if n not in table ])
+	if missing:
+		sys.stderr.write('%d orders were not found in time\n' % missing)
+	PrintTable(last, table)
+	return 0
+
+if __name__ == '__main__':
+	sys.exit(main(sys.argv[1:]))
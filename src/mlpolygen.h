@@ -0,0 +1,134 @@
+/*=============================================================================
+//  C interface of libmlpolygen
+//----------------------------------------------------------------------------
+//  This file is part of MLPolyGen, a maximal-length polynomial generator
+//  for linear feedback shift registers.
+//
+//  Copyright (C) 2012  Gregory E. Allen
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//===========================================================================*/
+
+#ifndef mlpolygen_h
+#define mlpolygen_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+//  Polynomials are passed as hex strings in the notation the command line
+//  prints (bit i is the tap x**(i+1), the top bit is x**order, +1 implied),
+//  with or without a leading 0x. The order of a polynomial is the position
+//  of its top bit. For orders up to 64 they can also be passed as uint64_t.
+//
+//  All functions may be called from any thread. A tester is not modified
+//  by testing, so one tester can serve many threads at once.
+*/
+
+/* return values */
+#define MLPG_ML          1   /* maximal length */
+#define MLPG_NOT_ML      0   /* not maximal length */
+#define MLPG_EINVAL     -1   /* malformed polynomial or argument */
+#define MLPG_EORDER     -2   /* polynomial does not match the tester's order */
+#define MLPG_ERANGE     -3   /* order not supported by this build */
+#define MLPG_EFAIL      -4   /* internal error, e.g. out of memory */
+
+/* the distinct prime factors of 2**order-1, shared by testers */
+typedef struct mlpg_cache mlpg_cache;
+
+/* tests and generates polynomials of one order */
+typedef struct mlpg_tester mlpg_tester;
+
+/* the output bit sequence of an LFSR */
+typedef struct mlpg_sequence mlpg_sequence;
+
+/* conventions of mlpg_sequence_create */
+#define MLPG_FIBONACCI   0
+#define MLPG_GALOIS      1
+
+/* receives each polynomial found, returns nonzero to stop */
+typedef int (*mlpg_poly_cb)(const char* poly, void* user);
+
+
+const char* mlpg_version(void);
+unsigned mlpg_max_order(void);   /* 64 without GMP */
+
+/* a NULL cache is the one mlpolygen itself uses, shared by the process */
+mlpg_cache* mlpg_cache_create(void);
+void mlpg_cache_destroy(mlpg_cache* cache);
+/* factors 2**order-1 now, returns the number of distinct primes or an error */
+int mlpg_cache_prepare(mlpg_cache* cache, unsigned order);
+/* writes the primes as decimal numbers separated by spaces, like snprintf */
+int mlpg_cache_factors(mlpg_cache* cache, unsigned order, char* buf, size_t size);
+/* adds the factors of 2**n-1 from a file of "PrimeFactorizer -s",
+   returns the number of distinct orders loaded or an error */
+int mlpg_cache_load(mlpg_cache* cache, const char* file_name);
+
+mlpg_tester* mlpg_tester_create(unsigned order, mlpg_cache* cache);
+void mlpg_tester_destroy(mlpg_tester* tester);
+unsigned mlpg_tester_order(const mlpg_tester* tester);
+
+int mlpg_test(const mlpg_tester* tester, const char* poly);
+int mlpg_test_u64(const mlpg_tester* tester, uint64_t poly);
+
+/* results[i] as for mlpg_test, threads 0 for one per CPU.
+   Returns the number of ML polynomials or an error */
+long mlpg_test_batch(const mlpg_tester* tester, const char* const* polys, size_t count, int* results, unsigned threads);
+long mlpg_test_batch_u64(const mlpg_tester* tester, const uint64_t* polys, size_t count, int* results, unsigned threads);
+
+/* the ML polynomials from start to end in increasing order (NULL for the
+   first/last), optionally only with min_taps..max_taps taps (0,0 for any).
+   Stops after max_count (0 for no limit) or when cb returns nonzero.
+   Returns the number of polynomials passed to cb or an error */
+long mlpg_generate(const mlpg_tester* tester, const char* start, const char* end,
+                   unsigned min_taps, unsigned max_taps, unsigned long max_count,
+                   mlpg_poly_cb cb, void* user);
+
+/* count ML polynomials, each the first one after a random starting point */
+long mlpg_random(const mlpg_tester* tester, unsigned long count, mlpg_poly_cb cb, void* user);
+
+/* any order, the sequence is maximal length if the polynomial is.
+   The seed is the initial state in hex, NULL for 1, and must not be 0.
+   FIBONACCI: the state holds the next order output bits, first in bit 0.
+   GALOIS: each step shifts the state right by one, outputs the bit
+   shifted out, and when it was 1, xors the state with the polynomial.
+   Returns NULL for malformed arguments */
+mlpg_sequence* mlpg_sequence_create(const char* poly, const char* seed, int convention);
+void mlpg_sequence_destroy(mlpg_sequence* seq);
+/* the next num_bits bits of the sequence, packed from bit 0 of buf[0] on
+   (the first one is the lowest bit of the seed). A partial last byte has
+   its unused bits cleared, the next call continues with the next bit */
+int mlpg_sequence_read(mlpg_sequence* seq, unsigned char* buf, uint64_t num_bits);
+/* skips the next steps bits, given in decimal or in hex with 0x, of any size */
+int mlpg_sequence_skip(mlpg_sequence* seq, const char* steps);
+int mlpg_sequence_skip_u64(mlpg_sequence* seq, uint64_t steps);
+/* skips index times (2**order-1)/count bits. For an ML polynomial, this is
+   the start of substream index of count equally spaced ones that do not
+   overlap, e.g. one per thread */
+int mlpg_sequence_substream(mlpg_sequence* seq, unsigned index, unsigned count);
+
+/* the state of an LFSR after steps (as for mlpg_sequence_skip) more steps,
+   in hex into buf like snprintf. Takes O(order**2 log steps) time */
+int mlpg_state_advance(const char* poly, int convention, const char* state,
+                       const char* steps, char* buf, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -49,6 +49,157 @@ clean: $(TEST_MKFS)
 	for file in $^; do $(MAKE) -f $$file clean-files; done
 	rm -rf files lengths*.txt
 
+serve-test: # start mlpolygen --serve and query it from several clients at once
+	@rm -f files/serve.sock; mkdir -p files
+	@$(MLPOLYGEN) --serve=files/serve.sock 2> files/serve.log & pid=$$!; \
+	for i in {1..50}; do [ -S files/serve.sock ] && break; sleep 0.1; done; \
+	python serve_client.py files/serve.sock 4; status=$$?; \
+	kill $$pid; wait $$pid; exit $$status
+
+coordinator-test: # search order 20 with --coordinator and two --worker processes
+	@rm -rf files/leases; mkdir -p files/leases
+	@$(MLPOLYGEN) --coordinator=files/leases.sock --lease-bits=4 --lease-dir=files/leases 20 \
+	  2> files/leases.log & pid=$$!; \
+	for i in {1..50}; do [ -S files/leases.sock ] && break; sleep 0.1; done; \
+	$(MLPOLYGEN) --worker=files/leases.sock & $(MLPOLYGEN) --worker=files/leases.sock; \
+	wait; cmp -s <(cat files/leases/mlpoly20-*.txt) <($(MLPOLYGEN) 20) && \
+	echo "coordinator of order 20: passed" || { echo "coordinator of order 20: FAILED"; exit 1; }
+
+stats-test: # check the counters of --stats-json and the --progress lines, order 20
+	@mkdir -p files; \
+	$(MLPOLYGEN) --stats-json=files/stats20.json --progress=0.001 20 > files/stats20.txt 2> files/progress20.txt && \
+	python -c 'import json, sys; s = json.load(open("files/stats20.json")); r = s["rejected"]; \
+	  n = len(open("files/stats20.txt").readlines()); \
+	  sys.exit(not (s["accepted"] == s["printed"] == n == 24000 and s["candidates"] == 2**18 and \
+	    s["accepted"] + s["prefiltered"] + r["stage1"] + r["stage2"] + r["stage3"] == s["candidates"]))' && \
+	grep -q "^progress: order 20, .* candidates of ~262144 " files/progress20.txt || \
+	{ echo "stats of order 20: FAILED"; exit 1; }; echo "stats of order 20: passed"
+
+index-test: # compare --kth, --next and --count from --build-index with the list, order 14
+	@mkdir -p files; $(MLPOLYGEN) 14 > files/index14.txt && \
+	$(MLPOLYGEN) --build-index --index=files/mlpoly14.idx 14 && \
+	n=$$(wc -l < files/index14.txt) && \
+	[ "$$($(MLPOLYGEN) --index=files/mlpoly14.idx --count 14)" = $$n ] && \
+	[ "$$($(MLPOLYGEN) --index=files/mlpoly14.idx --count -s 0x2400 -e 0x3000 14)" = \
+	  "$$($(MLPOLYGEN) -s 0x2400 -e 0x3000 14 | wc -l)" ] || \
+	{ echo "index of order 14, count: FAILED"; exit 1; }; \
+	for k in $$(seq 1 23 $$n) $$n; do \
+	  poly=$$(sed -n "$${k}p" files/index14.txt); \
+	  [ "$$($(MLPOLYGEN) --index=files/mlpoly14.idx --kth=$$k 14)" = $$poly ] && \
+	  [ "$$($(MLPOLYGEN) --index=files/mlpoly14.idx --next=0x$$poly 14 2>/dev/null)" = \
+	    "$$(sed -n "$$((k+1))p" files/index14.txt)" ] || \
+	  { echo "index of order 14, k $$k: FAILED"; exit 1; }; \
+	done; echo "index of order 14: passed"
+
+sequence-test: # check --emit-sequence against the recurrence of its poly, both LFSR types
+	@mkdir -p files; for poly in 0x12 0x13 0x834 0x8000000000000016 \
+	  0x800000000000000000000000000000000000000000000000000000000000000000025; do \
+	  $(MLPOLYGEN) --emit-sequence=$$poly --bits=2000 > files/sequence.bin && \
+	  python sequence_check.py recurrence $$poly files/sequence.bin && \
+	  $(MLPOLYGEN) --emit-sequence=$$poly --bits=2000 --seed=0x5 > files/sequence.bin && \
+	  python sequence_check.py recurrence $$poly files/sequence.bin && \
+	  $(MLPOLYGEN) --emit-sequence=$$poly --bits=2000 --galois > files/sequence.bin && \
+	  python sequence_check.py recurrence $$poly files/sequence.bin galois || \
+	  { echo "sequence of $$poly: FAILED"; exit 1; }; \
+	done; echo "sequences: passed"
+
+BITS = python sequence_check.py bits
+
+skip-test: # compare --skip and --substream with the stream cut where they start
+	@mkdir -p files; for poly in 0x834 0x8000000000000016 \
+	  0x800000000000000000000000000000000000000000000000000000000000000000025; do \
+	  for skip in 1 7 100 1000; do \
+	    $(MLPOLYGEN) --emit-sequence=$$poly --bits=$$((skip+1000)) > files/full.bin && \
+	    $(MLPOLYGEN) --emit-sequence=$$poly --bits=1000 --skip=$$skip > files/skip.bin && \
+	    [ "$$($(BITS) files/full.bin $$skip 1000)" = "$$($(BITS) files/skip.bin 0 1000)" ] && \
+	    $(MLPOLYGEN) --emit-sequence=$$poly --bits=$$((skip+1000)) --galois > files/full.bin && \
+	    $(MLPOLYGEN) --emit-sequence=$$poly --bits=1000 --skip=$$skip --galois > files/skip.bin && \
+	    [ "$$($(BITS) files/full.bin $$skip 1000)" = "$$($(BITS) files/skip.bin 0 1000)" ] || \
+	    { echo "skip $$skip of $$poly: FAILED"; exit 1; }; \
+	  done; \
+	done; \
+	$(MLPOLYGEN) --emit-sequence=0x834 --bits=4095 > files/full.bin && \
+	$(MLPOLYGEN) --emit-sequence=0x834 --bits=100 --skip=0x300e > files/skip.bin && \
+	[ "$$($(BITS) files/full.bin 17 100)" = "$$($(BITS) files/skip.bin 0 100)" ] || \
+	{ echo "skip of 0x834 past its period: FAILED"; exit 1; }; \
+	for i in 0 1 2 3 4; do \
+	  $(MLPOLYGEN) --emit-sequence=0x834 --substream=$$i/5 > files/skip.bin && \
+	  [ "$$($(BITS) files/full.bin $$((i*819)) 819)" = "$$($(BITS) files/skip.bin 0 819)" ] || \
+	  { echo "substream $$i/5 of 0x834: FAILED"; exit 1; }; \
+	done; echo "skip and substreams: passed"
+
+period-test: # the polys that --period finds of maximal length against the list, orders 2 to 12
+	@for order in {2..12}; do \
+	  cmp -s <($(MLPOLYGEN) $$order) \
+	    <(for ((p=1<<(order-1); p<1<<order; p++)); do printf '%x\n' $$p; done | \
+	      $(MLPOLYGEN) --period - | sed -n 's/^0x\([0-9a-f]*\) .*(maximal length).*/\1/p') || \
+	  { echo "period of order $$order: FAILED"; exit 1; }; \
+	done; echo "period of orders 2 to 12: passed"
+
+orders-test: # compare --orders=2-16 on threads with single orders and the plain list
+	@mkdir -p files; $(MLPOLYGEN) --orders=2-16 -j 4 > files/orders.txt && \
+	for order in {2..16}; do \
+	  record=$$(sed -n "$$((order-1))p" files/orders.txt); \
+	  [ "$$record" = "$$($(MLPOLYGEN) --orders=$$order)" ] && \
+	  [ "$$(echo "$$record" | sed 's/.*"count": \([0-9]*\).*/\1/')" = "$$($(MLPOLYGEN) $$order | wc -l)" ] && \
+	  [ "$$(echo "$$record" | sed 's/.*"first": \["\([0-9a-f]*\)"\].*/\1/')" = "$$($(MLPOLYGEN) -n 1 $$order)" ] || \
+	  { echo "orders, order $$order: FAILED"; exit 1; }; \
+	done; echo "orders 2 to 16: passed"
+
+cosets-test: # compare --cosets with the linear method, orders 2 to 16
+	@for order in {2..16}; do \
+	  cmp -s <($(MLPOLYGEN) $$order) <($(MLPOLYGEN) --cosets $$order) && \
+	  cmp -s <($(MLPOLYGEN) $$order) <($(MLPOLYGEN) --cosets -p --sorted $$order) || \
+	  { echo "cosets of order $$order: FAILED"; exit 1; }; \
+	done; echo "cosets of orders 2 to 16: passed"
+
+sparsest-test: # compare the --sparsest table with --min-weight, orders 2 to 64
+	@for order in {2..64}; do \
+	  [ "$$($(MLPOLYGEN) --sparsest=$$order)" = \
+	    "$$($(MLPOLYGEN) --orders=$$order --min-weight | sed 's/.*"min_weight": "\([0-9a-f]*\)".*/\1/')" ] || \
+	  { echo "sparsest of order $$order: FAILED"; exit 1; }; \
+	done; echo "sparsest of orders 2 to 64: passed"
+
+order64-test: # two polys of order 64 that 1<<64 let through as ML, and one that is
+	@for poly in 0x8000000000000046 0xd80000000000001d; do \
+	  $(MLPOLYGEN) -t $$poly | grep -q "NOT maximal length for order 64" || \
+	  { echo "order 64, $$poly: FAILED"; exit 1; }; \
+	done; \
+	$(MLPOLYGEN) -t 0x800000000000000d | grep -q "^0x800000000000000d is maximal length for order 64" || \
+	{ echo "order 64, 0x800000000000000d: FAILED"; exit 1; }; \
+	echo "order 64: passed"
+
+pairs-test: # check --gold and --kasami by cross-correlation, small orders
+	@mkdir -p files; for order in 3 5 6 7 9 10; do \
+	  $(MLPOLYGEN) $$order > files/pairs$$order.txt && \
+	  $(MLPOLYGEN) --gold $$order | python pairs_check.py gold $$order files/pairs$$order.txt || \
+	  { echo "gold of order $$order: FAILED"; exit 1; }; \
+	done; for order in 4 6 8 10; do \
+	  $(MLPOLYGEN) --kasami $$order | python pairs_check.py kasami $$order || \
+	  { echo "kasami of order $$order: FAILED"; exit 1; }; \
+	done; echo "gold and kasami of orders 3 to 10: passed"
+
+tune-test: # --tune order 16 into a file of its own, and search with and without it
+	@mkdir -p files; rm -f files/tune.txt
+	@MLPOLYGEN_TUNE=files/tune.txt $(MLPOLYGEN) --tune 16 && \
+	grep -q "	16	" files/tune.txt && \
+	cmp -s <(MLPOLYGEN_TUNE=files/tune.txt $(MLPOLYGEN) 16) <(MLPOLYGEN_TUNE=files/none.txt $(MLPOLYGEN) 16) && \
+	echo "tune of order 16: passed" || { echo "tune of order 16: FAILED"; exit 1; }
+
+irreducible-test: # count --irreducible against A001037, ML polys among them, orders 2 to 16
+	@counts=(0 0 1 2 3 6 9 18 30 56 99 186 335 630 1161 2182 4080); \
+	for order in {2..16}; do \
+	  [ $$($(MLPOLYGEN) --irreducible $$order | wc -l) -eq $${counts[$$order]} ] && \
+	  [ -z "$$(comm -23 <($(MLPOLYGEN) $$order) <($(MLPOLYGEN) --irreducible $$order))" ] || \
+	  { echo "irreducible of order $$order: FAILED"; exit 1; }; \
+	done; echo "irreducible of orders 2 to 16: passed"
+
+mersenne-test: # compare -2 of Mersenne exponents with --irreducible -w 2, up to 607
+	@for order in 3 5 7 13 17 19 31 61 89 107 127 521 607; do \
+	  cmp -s <($(MLPOLYGEN) -2 $$order | sed -n 's/^[0-9]*: 0x//p') <($(MLPOLYGEN) -b --irreducible -w 2 $$order) || \
+	  { echo "trinomials of order $$order: FAILED"; exit 1; }; \
+	done; echo "trinomials of Mersenne exponents 3 to 607: passed"
+
 gzcheck: # check that all .gz files are valid
 	find files -name mlpoly\*.txt.gz -print0 | xargs -0 gunzip -t
 
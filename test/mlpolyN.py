@@ -22,8 +22,8 @@
 # file of a specified order.
 # It splits the output space into as many as 2**16 subspaces
 # which can be executed in parallel and then merged together.
-# By using sort to perform the merging, we can leverage the
-# faster symmetric pairs method.
+# Each subspace is generated sorted with the faster symmetric pairs
+# method (-p --sorted), so merging only needs sort -m.
 # This approach provides:
 #  - concurrent execution to exploit parallelism, and
 #  - simple checkpointing so that the process can be stopped and restarted
@@ -50,7 +50,7 @@ def PrintSortRules(olist,ilist):
 		print '%s:' % olist[x],
 		subList = ilist[ x*entriesPerRule : x*entriesPerRule+entriesPerRule ]
 		print ' '.join(subList)
-		print '\tgunzip -c $^ | sort | gzip > $@'
+		print '\tsort -m $(patsubst %,<(gunzip -c %),$^) | gzip > $@'
 
 def PrintLeafRules(order, olist):
 	numSegments = len(olist)
@@ -69,7 +69,7 @@ def PrintLeafRules(order, olist):
 		sval = totalStartValue+s*incr
 		eval = sval+incr-1
 		print '%s:' % olist[s]
-		print '\t$(MLPOLYGEN) -p -s0x%x -e0x%x %d \\' % (sval,eval,order)
+		print '\t$(MLPOLYGEN) -p --sorted -s0x%x -e0x%x %d \\' % (sval,eval,order)
 		print '    | gzip > $@' 
 
 def main():
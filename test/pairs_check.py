@@ -0,0 +1,99 @@
+#!/usr/bin/env python
+# This file is part of MLPolyGen, a maximal-length polynomial generator
+# for linear feedback shift registers.
+#
+# Copyright (C) 2012  Gregory E. Allen
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+# Checks the output of mlpolygen --gold or --kasami by brute force.
+# Usage: mlpolygen --gold N | pairs_check.py gold N mlpolyN.txt
+#        mlpolygen --kasami N | pairs_check.py kasami N
+# For --gold, every pair of the ML polynomials in mlpolyN.txt (from
+# mlpolygen N) is cross-correlated, and the preferred ones must be
+# exactly those printed. For --kasami, the second polynomial must be
+# that of the first one's m-sequence decimated by 2**(N/2)+1. The third
+# polynomial must be the product of the first two.
+
+import itertools
+import sys
+
+def Taps(poly, order):
+	# mlpolygen notation: bit i is x**(i+1), x**0 is implied
+	return [0] + [ i+1 for i in range(order-1) if (poly >> i) & 1 ]
+
+def Sequence(poly, order, length):
+	# s(t+order) is the sum of s(t+i) over the taps x**i below x**order
+	taps = Taps(poly, order)
+	seq = [1] + [0]*(order-1)
+	while len(seq) < length:
+		t = len(seq)-order
+		seq.append(sum(seq[t+i] for i in taps) % 2)
+	return seq[:length]
+
+def Satisfies(seq, poly, order):
+	taps = Taps(poly, order)
+	return all(sum(seq[t+i] for i in taps) % 2 == seq[t+order] for t in range(len(seq)-order))
+
+def Mul(a, b):
+	# with x**0 added, and dropped again
+	a, b, c = a << 1 | 1, b << 1 | 1, 0
+	while b:
+		if b & 1:
+			c ^= a
+		a, b = a << 1, b >> 1
+	return c >> 1
+
+def Preferred(s, u, order):
+	n = len(s)
+	t = 1 + 2**((order+2)//2)
+	for shift in range(n):
+		c = sum(1 if s[i] == u[(i+shift) % n] else -1 for i in range(n))
+		if c not in (-1, -t, t-2):
+			return False
+	return True
+
+def main(argv):
+	mode, order = argv[0], int(argv[1])
+	lines = [ line.split('#')[0].split() for line in sys.stdin if line.strip() ]
+	period = 2**order-1
+	for a, b, g in lines:
+		if Mul(int(a, 16), int(b, 16)) != int(g, 16):
+			print('%s %s: the product is not %s' % (a, b, g))
+			return 1
+
+	if mode == 'kasami':
+		q = 2**(order//2)+1
+		for a, w, k in lines:
+			s = Sequence(int(a, 16), order, period*q)
+			if not Satisfies(s[::q], int(w, 16), order//2):
+				print('%s: %s is not its decimation by %d' % (a, w, q))
+				return 1
+		return 0
+
+	printed = set(frozenset((int(a, 16), int(b, 16))) for a, b, g in lines)
+	if len(printed) != len(lines):
+		print('pairs are printed more than once')
+		return 1
+	mls = [ int(line, 16) for line in open(argv[2]) if line.strip() ]
+	seqs = dict((p, Sequence(p, order, period)) for p in mls)
+	for p, r in itertools.combinations(mls, 2):
+		if Preferred(seqs[p], seqs[r], order) != (frozenset((p, r)) in printed):
+			print('%x %x: wrong' % (p, r))
+			return 1
+	return 0
+
+if __name__ == '__main__':
+	sys.exit(main(sys.argv[1:]))
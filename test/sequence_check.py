@@ -0,0 +1,70 @@
+#!/usr/bin/env python
+# This file is part of MLPolyGen, a maximal-length polynomial generator
+# for linear feedback shift registers.
+#
+# Copyright (C) 2012  Gregory E. Allen
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+# Checks the output of mlpolygen --emit-sequence against the recurrence
+# of its polynomial. Usage:
+#   mlpolygen --emit-sequence=POLY --bits=N > FILE
+#   sequence_check.py recurrence POLY FILE [galois]
+#   sequence_check.py bits FILE FIRST COUNT
+# The output of a Fibonacci LFSR satisfies the recurrence of POLY, that
+# of a Galois LFSR the one of its reciprocal. The bits mode prints
+# COUNT bits from FIRST as 0s and 1s, to compare a --skip with the bits
+# it skipped cut off.
+
+import sys
+
+def Bits(fileName):
+	# the first bit in bit 0 of the first byte
+	data = bytearray(open(fileName, 'rb').read())
+	return [ (byte >> i) & 1 for byte in data for i in range(8) ]
+
+def Taps(poly, order):
+	# mlpolygen notation: bit i is x**(i+1), x**0 is implied
+	return [0] + [ i+1 for i in range(order-1) if (poly >> i) & 1 ]
+
+def Reciprocal(poly, order):
+	full = bin(poly << 1 | 1)[2:].zfill(order+1)
+	return int(full[::-1], 2) >> 1
+
+def Satisfies(seq, poly, order):
+	taps = Taps(poly, order)
+	return all(sum(seq[t+i] for i in taps) % 2 == seq[t+order] for t in range(len(seq)-order))
+
+def main(argv):
+	if argv[0] == 'recurrence':
+		poly = int(argv[1], 16)
+		order = poly.bit_length()
+		if argv[3:] == ['galois']:
+			poly = Reciprocal(poly, order)
+		seq = Bits(argv[2])
+		if len(seq) <= order or not Satisfies(seq, poly, order):
+			print('%s: not the sequence of %s' % (argv[2], argv[1]))
+			return 1
+		return 0
+	if argv[0] == 'bits':
+		first, count = int(argv[2]), int(argv[3])
+		seq = Bits(argv[1])[first:first+count]
+		print(''.join(str(b) for b in seq))
+		return 0 if len(seq) == count else 1
+	print('unknown mode %s' % argv[0])
+	return 1
+
+if __name__ == '__main__':
+	sys.exit(main(sys.argv[1:]))
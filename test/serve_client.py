@@ -0,0 +1,101 @@
+#!/usr/bin/env python
+# This file is part of MLPolyGen, a maximal-length polynomial generator
+# for linear feedback shift registers.
+# 
+# Copyright (C) 2012  Gregory E. Allen
+# 
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+# 
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+# A client for mlpolygen --serve, which checks the replies against
+# known ML polynomials. Usage: serve_client.py SOCKET [numThreads]
+# Several threads send their requests on separate connections at once.
+
+import socket
+import sys
+import threading
+
+class Client:
+	def __init__(self, path):
+		self.sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+		self.sock.connect(path)
+		self.rfile = self.sock.makefile('r')
+
+	def request(self, line):
+		self.sock.sendall((line+'\n').encode('ascii'))
+		return self.rfile.readline().rstrip('\n')
+
+	def close(self):
+		self.sock.sendall(b'quit\n')
+		self.sock.close()
+
+# (request, expected reply)
+checks = [
+	('test b354', 'ok 1'),
+	('test 0xb355', 'ok 0'),
+	('test 8016', 'ok 1'),
+	('next 8016', 'ok 801c'),
+	('next ff00', 'ok ff12'),
+	('next ffff', 'ok none'),
+	('batch 8016 801c 801d 3 c', 'ok 1 1 0 1 1'),
+	('test 8000000000000001000000000', 'ok 1'),
+	('test xyz', 'err order must be 1 .. '),
+	('random 32 100000000000', 'err count above 65536'),
+	('bogus', "err unknown command 'bogus'"),
+]
+
+errors = []
+
+def worker(path, rounds):
+	client = Client(path)
+	for r in range(rounds):
+		for req, expected in checks:
+			reply = client.request(req)
+			if not reply.startswith(expected):
+				errors.append('%s: got "%s", expected "%s"' % (req, reply, expected))
+		reply = client.request('random 16 3').split()
+		if len(reply)!=4 or reply[0]!='ok':
+			errors.append('random 16 3: got "%s"' % ' '.join(reply))
+		else:
+			for poly in reply[1:]:
+				if client.request('test '+poly) != 'ok 1':
+					errors.append('random poly %s is not ML' % poly)
+	client.close()
+
+def main():
+	path = sys.argv[1]
+	numThreads = 4
+	if len(sys.argv)>=3:
+		numThreads = int(sys.argv[2])
+	threads = [ threading.Thread(target=worker, args=(path,10)) for t in range(numThreads) ]
+	for t in threads:
+		t.start()
+	for t in threads:
+		t.join()
+
+	client = Client(path)
+	client.sock.sendall(b'stats\n')
+	line = client.rfile.readline()
+	while line and line.strip()!='.':
+		sys.stdout.write(line)
+		line = client.rfile.readline()
+	client.close()
+
+	for e in errors:
+		print(e)
+	print('serve test %s' % ('FAILED' if errors else 'passed'))
+	sys.exit(1 if errors else 0)
+
+if __name__ == '__main__':
+	main()